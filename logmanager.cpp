@@ -4,15 +4,24 @@
 #include <spdlog/spdlog.h>
 #include <spdlog/async.h>
 #include <spdlog/details/thread_pool.h>
+#include <spdlog/pattern_formatter.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
+#include <spdlog/sinks/nonblocking_console_sink.h>
 #include <spdlog/sinks/daily_file_sink.h>
 #include <spdlog/sinks/rotating_file_sink.h>
+#include <spdlog/sinks/mmap_file_sink.h>
 
 #include <iostream>
 #include <fstream>
 #include <filesystem>
 #include <chrono>
 #include <ctime>
+#include <cstring>
+#include <atomic>
+#include <unordered_map>
+
+#include <QThread>
+#include <QString>
 
 #include "estream.h"
 
@@ -40,7 +49,87 @@ spdlog::level::level_enum LogManagerPrivate::toSpdlogLevel(int level) {
     return spdlog::level::info;
 }
 
+// 线程id -> Qt 线程名, 异步日志在工作线程格式化, 只能按 id 查名称
+static std::mutex                              g_thread_names_mutex;
+static std::unordered_map<size_t, std::string> g_thread_names;
+static std::atomic<uint64_t>                   g_thread_names_version{0};
+
+static void setThreadName(size_t id, const QString& name) {
+    std::lock_guard<std::mutex> lock(g_thread_names_mutex);
+    if (name.isEmpty()) {
+        g_thread_names.erase(id);
+    } else {
+        g_thread_names[id] = name.toStdString();
+    }
+    g_thread_names_version.fetch_add(1, std::memory_order_release);
+}
+
+// 在调用线程登记当前 Qt 线程名, 每个线程只在第一次输出日志时登记一次
+// 之后线程改名由 objectNameChanged 信号更新, 不用每条日志都取 objectName
+static void registerThreadName() {
+    thread_local bool registered = false;
+    if (registered) {
+        return;
+    }
+    registered = true;
+    QThread* thread = QThread::currentThread();
+    if (!thread) {
+        return;
+    }
+    const auto id = spdlog::details::os::thread_id();
+    setThreadName(id, thread->objectName());
+    QObject::connect(thread, &QObject::objectNameChanged, [id](const QString& name) {
+        setThreadName(id, name);
+    });
+}
+
+// %N: Qt 线程名, 未命名的线程输出线程 id
+// 和 %t 一样按线程 id 直接映射一个小缓存, 异步工作线程交替格式化几个线程的日志时也基本命中,
+// 登记表没有变化时只拷贝一次内存
+class QtThreadNameFlag : public spdlog::custom_flag_formatter {
+public:
+    void format(const spdlog::details::log_msg& msg, const std::tm&, spdlog::memory_buf_t& dest) override {
+        /// 同步日志在调用线程格式化, 没经过 LogStream 的线程也在这里登记
+        if (msg.thread_id == spdlog::details::os::thread_id()) {
+            registerThreadName();
+        }
+        struct CacheEntry {
+            bool        valid = false;
+            size_t      id = 0;
+            uint64_t    version = 0;
+            std::string text;
+        };
+        thread_local CacheEntry cache[16];
+        CacheEntry& entry = cache[msg.thread_id % 16];
+        const auto version = g_thread_names_version.load(std::memory_order_acquire);
+        if (!entry.valid || entry.id != msg.thread_id || entry.version != version) {
+            std::lock_guard<std::mutex> lock(g_thread_names_mutex);
+            const auto iter = g_thread_names.find(msg.thread_id);
+            entry.text = iter != g_thread_names.end() ? iter->second : std::to_string(msg.thread_id);
+            entry.id = msg.thread_id;
+            entry.version = version;
+            entry.valid = true;
+        }
+        const size_t size = dest.size();
+        dest.resize(size + entry.text.size());
+        std::memcpy(dest.data() + size, entry.text.data(), entry.text.size());
+    }
+
+    std::unique_ptr<spdlog::custom_flag_formatter> clone() const override {
+        return spdlog::details::make_unique<QtThreadNameFlag>();
+    }
+
+    /// 输出只取决于消息的线程 id, 各个 sink 可以共用一次格式化结果
+    std::string signature() const override {
+        return "qt_thread_name";
+    }
+};
+
 std::shared_ptr<spdlog::logger> LogManagerPrivate::getLogger(const std::string& name) {
+    /// 输出线程名时 在调用线程登记名称 (异步日志的工作线程拿不到)
+    if (_thread_name) {
+        registerThreadName();
+    }
     /// 按照名称取一个
     auto iter = _loggers.find(name);
     if (iter != _loggers.end()) {
@@ -90,14 +179,14 @@ LogManager::LogManager() : d_ptr(new LogManagerPrivate) {
 void LogManager::init(const int q_size, const int thread_count ) {
     if (!d_ptr->_init) {
         d_ptr->_init = true;
+        d_ptr->_q_size = q_size;
+        d_ptr->_thread_count = thread_count;
 #ifdef _WIN32
         // 设置输入输出编码为 UTF-8
         SetConsoleCP(65001);   // 控制台输入编码
         SetConsoleOutputCP(65001);  // 控制台输出编码
 #endif
-        // 第一个参数是队列大小，第二个参数是工作线程数
-        // 注释掉线程池初始化，使用同步模式
-        // spdlog::init_thread_pool(q_size, thread_count);
+        // 线程池在第一个 async 配置添加时才创建 (见 addConfig), 默认使用同步模式
 
         // 初始化spdlog
         spdlog::set_pattern("[%Y-%m-%d %H:%M:%S.%e] [pid:%P] [thread:%t] [%n] [%^%l%$] %v");
@@ -115,19 +204,46 @@ void LogManager::addConfig(const LogConfig& config)
         std::vector<spdlog::sink_ptr> sinks;
 
         // 3. 文件sink
-        auto file_sink = std::make_shared<spdlog::sinks::rotating_file_sink_mt>(config.filepath + "/" + config.filename, config.max_size, 100000);
-        sinks.push_back(file_sink);
+        if (config.mmap) {
+            // 写日志只是一次 memcpy, 下一个分段提前映射好
+            sinks.push_back(std::make_shared<spdlog::sinks::mmap_file_sink_mt>(config.filepath + "/" + config.filename, config.max_size, 100000));
+        } else {
+            sinks.push_back(std::make_shared<spdlog::sinks::rotating_file_sink_mt>(config.filepath + "/" + config.filename, config.max_size, 100000));
+        }
 
         // 4. 控制台sink（始终添加，确保在控制台中看到日志输出）
-        auto console_sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
+        spdlog::sink_ptr console_sink;
+        if (config.console_nonblocking) {
+            // 由 sink 自己的线程写控制台, 写日志的线程不会因终端卡住而阻塞
+            console_sink = std::make_shared<spdlog::sinks::nonblocking_console_sink>();
+        } else {
+            console_sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
+        }
         console_sink->set_level(spdlog::level::trace); // 设置控制台sink的日志级别为trace
         sinks.push_back(console_sink);
 
         // 5. 创建logger
-        auto logger = std::make_shared<spdlog::logger>(config.logger_name, sinks.begin(), sinks.end());
+        std::shared_ptr<spdlog::logger> logger;
+        if (config.async) {
+            // 第一个参数是队列大小，第二个参数是工作线程数
+            if (!spdlog::thread_pool()) {
+                spdlog::init_thread_pool(d_ptr->_q_size, d_ptr->_thread_count);
+            }
+            logger = std::make_shared<spdlog::async_logger>(config.logger_name, sinks.begin(), sinks.end(),
+                                                            spdlog::thread_pool(), spdlog::async_overflow_policy::block);
+        } else {
+            logger = std::make_shared<spdlog::logger>(config.logger_name, sinks.begin(), sinks.end());
+        }
 
         // 6. 设置日志格式和级别
-        logger->set_pattern("[%Y-%m-%d %H:%M:%S.%e] [pid:%P] [thread:%t] [%n] [%^%l%$] %v");
+        if (config.thread_name) {
+            d_ptr->_thread_name = true;
+            auto formatter = std::make_unique<spdlog::pattern_formatter>();
+            formatter->add_flag<QtThreadNameFlag>('N').set_pattern("[%Y-%m-%d %H:%M:%S.%e] [pid:%P] [thread:%N] [%n] [%^%l%$] %v");
+            logger->set_formatter(std::move(formatter));
+        } else {
+            logger->set_pattern("[%Y-%m-%d %H:%M:%S.%e] [pid:%P] [thread:%t] [%n] [%^%l%$] %v");
+        }
         logger->set_level(d_ptr->toSpdlogLevel(config.level));
         logger->flush_on(d_ptr->toSpdlogLevel(config.level));
 
@@ -171,6 +287,64 @@ void LogManager::setLevel(int level) const {
     // spdlog::set_level(d_ptr->toSpdlogLevel(level));
 }
 
+// 转换延迟分布
+static LogLatency toLogLatency(const spdlog::details::latency_histogram& histogram) {
+    LogLatency latency;
+    latency.count = histogram.count();
+    latency.p50 = histogram.percentile(0.5);
+    latency.p99 = histogram.percentile(0.99);
+    latency.p999 = histogram.percentile(0.999);
+    latency.max = histogram.max();
+    return latency;
+}
+
+// 获取异步日志统计信息
+LogStats LogManager::stats() const {
+    LogStats result;
+    auto tp = spdlog::thread_pool();
+    if (!tp) {
+        return result;
+    }
+    const auto pool_stats = tp->stats();
+    result.queue_size = pool_stats.queue_size;
+    result.queue_high_water_mark = pool_stats.queue_high_water_mark;
+    result.overrun = pool_stats.overrun_counter;
+    result.discard = pool_stats.discard_counter;
+    result.priority_overrun = pool_stats.priority_overrun_counter;
+    result.priority_discard = pool_stats.priority_discard_counter;
+
+    {
+        // 根据两次快照计算速率
+        std::lock_guard<std::mutex> lock(d_ptr->_stats_mutex);
+        const auto now = std::chrono::steady_clock::now();
+        const double seconds = std::chrono::duration<double>(now - d_ptr->_stats_last_time).count();
+        if (seconds > 0) {
+            result.msgs_per_sec = (pool_stats.msgs_processed - d_ptr->_stats_last_msgs) / seconds;
+            result.bytes_per_sec = (pool_stats.bytes_processed - d_ptr->_stats_last_bytes) / seconds;
+        }
+        d_ptr->_stats_last_time = now;
+        d_ptr->_stats_last_msgs = pool_stats.msgs_processed;
+        d_ptr->_stats_last_bytes = pool_stats.bytes_processed;
+    }
+
+    for (auto& pair : d_ptr->_loggers) {
+        auto logger = std::dynamic_pointer_cast<spdlog::async_logger>(pair.second);
+        if (!logger) {
+            continue;
+        }
+        const auto& logger_stats = logger->stats();
+        LogLoggerStats item;
+        item.logger_name = pair.first;
+        item.queue_latency = toLogLatency(logger_stats.enqueue_to_dequeue);
+        item.write_latency = toLogLatency(logger_stats.dequeue_to_written);
+        for (size_t i = 0; i < logger_stats.sink_count(); ++i) {
+            item.sink_latency.push_back(toLogLatency(*logger_stats.sink_latency(i)));
+        }
+        result.loggers.push_back(item);
+    }
+    return result;
+}
+
 // 创建日志流
 LogStream LogManager::trace(const std::string& logger_name) const {
     auto logger = d_ptr->getLogger(logger_name);
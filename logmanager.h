@@ -4,6 +4,8 @@
 
 
 #include <string>
+#include <vector>
+#include <cstdint>
 #include "logstream.h"
 
 
@@ -16,6 +18,40 @@ struct LogConfig {
     int days_to_keep = 10;             // 保留日志天数
     bool auto_cleanup = true;          // 是否自动清理日志
     bool console = true;               // 是否输出到控制台
+    bool async = false;                // 是否异步写日志 (使用 init 创建的线程池)
+    bool thread_name = false;          // 是否输出 Qt 线程名 (QThread::objectName) 代替线程 id, 未命名的线程仍输出 id
+    bool mmap = false;                 // 是否通过内存映射写日志文件 (按 max_size 预分配分段, 进程崩溃不丢日志)
+    bool console_nonblocking = false;  // 控制台输出是否不阻塞写日志的线程 (终端/管道过慢时丢弃日志并计数)
+};
+
+// 延迟分布, 单位: 纳秒
+struct LogLatency {
+    uint64_t count = 0;     // 样本数
+    uint64_t p50 = 0;
+    uint64_t p99 = 0;
+    uint64_t p999 = 0;
+    uint64_t max = 0;
+};
+
+// 单个异步日志器的延迟统计
+struct LogLoggerStats {
+    std::string logger_name;                // 日志名称
+    LogLatency queue_latency;               // 入队 -> 出队
+    LogLatency write_latency;               // 出队 -> 写完所有 sink
+    std::vector<LogLatency> sink_latency;   // 每个 sink 的写入耗时, 按 sink 添加顺序
+};
+
+// 异步日志统计, 只读计数器, 开销可忽略
+struct LogStats {
+    size_t queue_size = 0;                  // 当前队列长度
+    size_t queue_high_water_mark = 0;       // 队列最高水位
+    size_t overrun = 0;                     // 队列满时被覆盖的消息数
+    size_t discard = 0;                     // 队列满时被丢弃的消息数
+    size_t priority_overrun = 0;            // 高优先级通道 被覆盖的消息数
+    size_t priority_discard = 0;            // 高优先级通道 被丢弃的消息数
+    double msgs_per_sec = 0;                // 每秒写入消息数 (自上次调用 stats 起)
+    double bytes_per_sec = 0;               // 每秒写入字节数 (自上次调用 stats 起)
+    std::vector<LogLoggerStats> loggers;    // 异步日志器 (同步日志器没有延迟统计)
 };
 
 class LogManagerPrivate;
@@ -45,6 +81,12 @@ public:
     */
    void setLevel(int level = 2) const;
 
+   /*!
+    * @brief 获取异步日志统计信息 (队列水位, 吞吐, 延迟分布)
+    *        未开启异步日志时, 只返回空统计
+    */
+   LogStats stats() const;
+
    // 创建日志流
    LogStream trace(const std::string& logger_name="log") const;
    LogStream debug(const std::string& logger_name="log") const;
@@ -98,6 +140,11 @@ private:
       * @param max_size     单个日志文本大小, 默认50M
       * @param days_to_keep 保留日志天数, 默认10天
       * @param auto_cleanup 是否自动清理日志, 默认true
+      * @param console      是否输出到控制台, 默认true
+      * @param async        是否异步写日志, 默认false
+      * @param thread_name  是否输出 Qt 线程名代替线程 id, 默认false
+      * @param mmap         是否通过内存映射写日志文件, 默认false
+      * @param console_nonblocking 控制台输出是否不阻塞写日志的线程, 默认false
  * @return
 */
 #define LogAddConfig            LogManager::instance().addConfig
@@ -10,6 +10,7 @@
 #include <thread>
 #include <mutex>
 #include <map>
+#include <chrono>
 
 class LogManagerPrivate {
 public:
@@ -27,6 +28,15 @@ public:
     int                 _cleanup_days_to_keep = 10;         //  保留天数
     bool                _cleanup_auto = false;              //  是否自动清理日志
     bool                _init = false;                      //  是否初始化
+    int                 _q_size = 8192;                     //  异步队列大小
+    int                 _thread_count = 1;                  //  异步工作线程数
+    std::atomic<bool>   _thread_name = false;               //  是否有日志器输出 Qt 线程名
+
+    // 统计 计算速率用的上次快照
+    std::mutex                              _stats_mutex;
+    std::chrono::steady_clock::time_point   _stats_last_time = std::chrono::steady_clock::now();
+    uint64_t                                _stats_last_msgs = 0;
+    uint64_t                                _stats_last_bytes = 0;
 
     std::shared_ptr<spdlog::logger> getLogger(const std::string& name);
 };
@@ -6,13 +6,10 @@
 //
 // Async logging using global thread pool
 // All loggers created here share same global thread pool.
-// Each log message is pushed to a queue along with a shared pointer to the
-// logger.
-// If a logger deleted while having pending messages in the queue, it's actual
-// destruction will defer
-// until all its messages are processed by the thread pool.
-// This is because each message in the queue holds a shared_ptr to the
+// Each log message is pushed to a queue along with the thread pool slot of the
 // originating logger.
+// If a logger deleted while having pending messages in the queue, it's
+// destructor will wait until all its messages are processed by the thread pool.
 
 #include <spdlog/async_logger.h>
 #include <spdlog/details/registry.h>
@@ -10,9 +10,51 @@
 #include <spdlog/details/thread_pool.h>
 #include <spdlog/sinks/sink.h>
 
+#include <chrono>
 #include <memory>
 #include <string>
 
+SPDLOG_INLINE size_t spdlog::details::async_logger_stats::sink_count() const {
+    const auto *table = current_table_.load(std::memory_order_acquire);
+    return table != nullptr ? table->histograms.size() : 0;
+}
+
+SPDLOG_INLINE const spdlog::details::latency_histogram *
+spdlog::details::async_logger_stats::sink_latency(size_t sink_index) const {
+    const auto *table = current_table_.load(std::memory_order_acquire);
+    return table != nullptr && sink_index < table->histograms.size()
+               ? table->histograms[sink_index]
+               : nullptr;
+}
+
+SPDLOG_INLINE void spdlog::details::async_logger_stats::reserve_sinks_(size_t n) {
+    std::lock_guard<std::mutex> lock(sinks_mutex_);
+    if (sink_latency_.size() >= n) {
+        return;
+    }
+    while (sink_latency_.size() < n) {
+        sink_latency_.emplace_back(new latency_histogram());
+    }
+    std::unique_ptr<sink_table> table(new sink_table());
+    for (auto &histogram : sink_latency_) {
+        table->histograms.push_back(histogram.get());
+    }
+    current_table_.store(table.get(), std::memory_order_release);
+    tables_.push_back(std::move(table));
+}
+
+// histograms are never removed, so returned references stay valid
+SPDLOG_INLINE spdlog::details::latency_histogram &
+spdlog::details::async_logger_stats::sink_latency_at_(size_t sink_index) {
+    const auto *table = current_table_.load(std::memory_order_acquire);
+    if (table == nullptr || sink_index >= table->histograms.size()) {
+        // a sink was added through logger::sinks() since the last table was made
+        reserve_sinks_(sink_index + 1);
+        table = current_table_.load(std::memory_order_acquire);
+    }
+    return *table->histograms[sink_index];
+}
+
 SPDLOG_INLINE spdlog::async_logger::async_logger(std::string logger_name,
                                                  sinks_init_list sinks_list,
                                                  std::weak_ptr<details::thread_pool> tp,
@@ -30,10 +72,41 @@ SPDLOG_INLINE spdlog::async_logger::async_logger(std::string logger_name,
     : async_logger(
           std::move(logger_name), {std::move(single_sink)}, std::move(tp), overflow_policy) {}
 
+SPDLOG_INLINE spdlog::async_logger::async_logger(const async_logger &other)
+    : std::enable_shared_from_this<async_logger>(),
+      logger(other),
+      thread_pool_(other.thread_pool_),
+      overflow_policy_(other.overflow_policy_) {
+    stats_.reserve_sinks_(sinks_.size());
+    register_with_pool_();
+}
+
+SPDLOG_INLINE spdlog::async_logger::async_logger(const async_logger &other, backend_tag)
+    : std::enable_shared_from_this<async_logger>(),
+      logger(other),
+      overflow_policy_(other.overflow_policy_) {
+    stats_.reserve_sinks_(sinks_.size());
+}
+
+SPDLOG_INLINE spdlog::async_logger::~async_logger() {
+    SPDLOG_TRY {
+        if (auto pool_ptr = thread_pool_.lock()) {
+            pool_ptr->release_logger(pool_slot_);
+        }
+    }
+    SPDLOG_CATCH_STD
+}
+
+SPDLOG_INLINE void spdlog::async_logger::register_with_pool_() {
+    if (auto pool_ptr = thread_pool_.lock()) {
+        pool_slot_ = pool_ptr->register_logger(this);
+    }
+}
+
 // send the log message to the thread pool
 SPDLOG_INLINE void spdlog::async_logger::sink_it_(const details::log_msg &msg){
     SPDLOG_TRY{if (auto pool_ptr = thread_pool_.lock()){
-        pool_ptr -> post_log(shared_from_this(), msg, overflow_policy_);
+        pool_ptr -> post_log(pool_slot_, msg, overflow_policy_);
 }
 else {
     throw_spdlog_ex("async log: thread pool doesn't exist anymore");
@@ -45,7 +118,7 @@ SPDLOG_LOGGER_CATCH(msg.source)
 // send flush request to the thread pool
 SPDLOG_INLINE void spdlog::async_logger::flush_(){
     SPDLOG_TRY{if (auto pool_ptr = thread_pool_.lock()){
-        pool_ptr -> post_flush(shared_from_this(), overflow_policy_);
+        pool_ptr -> post_flush(pool_slot_, overflow_policy_);
 }
 else {
     throw_spdlog_ex("async flush: thread pool doesn't exist anymore");
@@ -58,10 +131,18 @@ SPDLOG_LOGGER_CATCH(source_loc())
 // backend functions - called from the thread pool to do the actual job
 //
 SPDLOG_INLINE void spdlog::async_logger::backend_sink_it_(const details::log_msg &msg) {
-    for (auto &sink : sinks_) {
+    using std::chrono::steady_clock;
+    memory_buf_t formatted;
+    uint64_t formatted_key = 0;
+    for (size_t i = 0; i < sinks_.size(); i++) {
+        auto &sink = sinks_[i];
         if (sink->should_log(msg.level)) {
-            SPDLOG_TRY { sink->log(msg); }
+            const auto start = steady_clock::now();
+            SPDLOG_TRY { sink_shared_(*sink, msg, formatted, formatted_key); }
             SPDLOG_LOGGER_CATCH(msg.source)
+            stats_.sink_latency_at_(i).record(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(steady_clock::now() - start)
+                    .count()));
         }
     }
 
@@ -11,11 +11,18 @@
 //    1. Checks if its log level is enough to log the message
 //    2. Push a new copy of the message to a queue (or block the caller until
 //    space is available in the queue)
-// Upon destruction, logs all remaining messages in the queue before
-// destructing..
+// Upon destruction, the messages still in the queue are logged by a copy of the
+// logger which the thread pool keeps until they are done, so destroying the
+// logger doesn't wait for the queue.
 
+#include <spdlog/details/latency_histogram.h>
 #include <spdlog/logger.h>
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
 namespace spdlog {
 
 // Async overflow policy - block by default.
@@ -23,12 +30,43 @@ enum class async_overflow_policy {
     block,           // Block until message can be enqueued
     overrun_oldest,  // Discard oldest message in the queue if full when trying to
                      // add new item.
-    discard_new      // Discard new message if the queue is full when trying to add new item.
+    discard_new,     // Discard new message if the queue is full when trying to add new item.
+    spill_to_disk    // Append to the thread pool's spill file if the queue is full, replayed in
+                     // order once the queue drained (see thread_pool::set_spill_file).
 };
 
+class async_logger;
+
 namespace details {
 class thread_pool;
-}
+
+// Latencies (in nanos) recorded by the thread pool worker for one async logger.
+struct async_logger_stats {
+    latency_histogram enqueue_to_dequeue;
+    latency_histogram dequeue_to_written;  // all sinks of the logger
+
+    // time spent in each sink's log(), by sink position in logger::sinks()
+    size_t sink_count() const;
+    const latency_histogram *sink_latency(size_t sink_index) const;
+
+private:
+    friend class spdlog::async_logger;
+
+    // the workers read the current table without locking. a table is replaced (under
+    // sinks_mutex_) only when sinks were added, and the old ones are kept until destruction.
+    struct sink_table {
+        std::vector<latency_histogram *> histograms;
+    };
+    std::mutex sinks_mutex_;
+    std::vector<std::unique_ptr<latency_histogram>> sink_latency_;
+    std::vector<std::unique_ptr<sink_table>> tables_;
+    std::atomic<const sink_table *> current_table_{nullptr};
+
+    // make sure there is a histogram for each of n sinks
+    void reserve_sinks_(size_t n);
+    latency_histogram &sink_latency_at_(size_t sink_index);
+};
+}  // namespace details
 
 class SPDLOG_API async_logger final : public std::enable_shared_from_this<async_logger>,
                                       public logger {
@@ -43,7 +81,10 @@ public:
                  async_overflow_policy overflow_policy = async_overflow_policy::block)
         : logger(std::move(logger_name), begin, end),
           thread_pool_(std::move(tp)),
-          overflow_policy_(overflow_policy) {}
+          overflow_policy_(overflow_policy) {
+        stats_.reserve_sinks_(sinks_.size());
+        register_with_pool_();
+    }
 
     async_logger(std::string logger_name,
                  sinks_init_list sinks_list,
@@ -55,8 +96,17 @@ public:
                  std::weak_ptr<details::thread_pool> tp,
                  async_overflow_policy overflow_policy = async_overflow_policy::block);
 
+    async_logger(const async_logger &other);
+    async_logger &operator=(const async_logger &) = delete;
+
+    // doesn't wait for the queue: the thread pool logs the messages still queued with a copy of
+    // this logger (see thread_pool::release_logger)
+    ~async_logger() override;
+
     std::shared_ptr<logger> clone(std::string new_name) override;
 
+    const details::async_logger_stats &stats() const { return stats_; }
+
 protected:
     void sink_it_(const details::log_msg &msg) override;
     void flush_() override;
@@ -64,8 +114,16 @@ protected:
     void backend_flush_();
 
 private:
+    // copy left to the thread pool by release_logger(), attached to no pool
+    struct backend_tag {};
+    async_logger(const async_logger &other, backend_tag);
+
     std::weak_ptr<details::thread_pool> thread_pool_;
     async_overflow_policy overflow_policy_;
+    size_t pool_slot_ = static_cast<size_t>(-1);
+    details::async_logger_stats stats_;
+
+    void register_with_pool_();
 };
 }  // namespace spdlog
 
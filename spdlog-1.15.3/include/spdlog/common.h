@@ -296,6 +296,17 @@ enum class pattern_time_type {
     utc     // log utc
 };
 
+//
+// How async workers wait for new messages when their queue is empty.
+// block by default.
+//
+enum class async_wait_strategy {
+    block,       // park on the queue's condition variable right away
+    busy_spin,   // spin with a cpu pause instruction, never park
+    spin_yield,  // spin for the spin budget, then yield the cpu in a loop, never park
+    spin_park    // spin for the spin budget, then park on the condition variable (futex)
+};
+
 //
 // Log exception
 //
@@ -0,0 +1,399 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+//
+// Pattern formatter whose pattern is parsed at compile time (requires C++20).
+// The pattern is turned into a flat list of tokens, adjacent literal text is
+// merged, and every flag is expanded inline, so formatting a message costs no
+// virtual calls and no padding checks. Runs of date/time flags (and the text
+// between them) are rendered once a second, like pattern_formatter does.
+//
+// Usage:
+//   auto f = std::make_unique<spdlog::compiled_formatter<"[%H:%M:%S.%e] [%^%l%$] %v">>();
+//   logger->set_formatter(std::move(f));
+//
+// Supported flags: %Y %C %m %d %H %M %S %e %f %F %E %D %T %R %P %t %n %l %L %v
+// %^ %$ %s %g %# %! and %%. Padding and custom flags are not supported, use
+// pattern_formatter for those. An unsupported flag fails to compile.
+//
+
+#include <spdlog/common.h>
+#include <spdlog/details/fmt_helper.h>
+#include <spdlog/details/id_text.h>
+#include <spdlog/details/log_msg.h>
+#include <spdlog/details/os.h>
+#include <spdlog/details/tz_cache.h>
+#include <spdlog/formatter.h>
+
+#if defined(__cpp_nontype_template_args) && __cpp_nontype_template_args >= 201911L
+
+    #include <array>
+    #include <chrono>
+    #include <cstring>
+    #include <ctime>
+    #include <memory>
+    #include <string>
+    #include <utility>
+
+namespace spdlog {
+namespace details {
+namespace compiled {
+
+// string literal usable as a template argument
+template <size_t N>
+struct fixed_string {
+    constexpr fixed_string(const char (&str)[N]) {
+        for (size_t i = 0; i < N; i++) {
+            data[i] = str[i];
+        }
+    }
+
+    constexpr size_t size() const { return N - 1; }
+    constexpr char operator[](size_t i) const { return data[i]; }
+
+    char data[N]{};
+};
+
+// flag == 0 means literal text at [offset, offset + size) of the literals array.
+// flag == datetime_flag means the tokens [offset, offset + size), rendered once a second
+// into the cache of index group.
+constexpr char datetime_flag = 1;
+
+struct token {
+    char flag = 0;
+    size_t offset = 0;
+    size_t size = 0;
+    size_t group = 0;
+};
+
+template <size_t N>
+struct pattern {
+    std::array<token, N> tokens{};
+    size_t token_count = 0;
+    std::array<char, N> literals{};
+    // what format() goes through: the tokens, with the datetime groups in place of the
+    // tokens they cache
+    std::array<token, N> steps{};
+    size_t step_count = 0;
+    size_t group_count = 0;
+};
+
+constexpr bool is_supported_flag(char flag) {
+    switch (flag) {
+        case 'Y':
+        case 'C':
+        case 'm':
+        case 'd':
+        case 'H':
+        case 'M':
+        case 'S':
+        case 'e':
+        case 'f':
+        case 'F':
+        case 'E':
+        case 'D':
+        case 'T':
+        case 'R':
+        case 'P':
+        case 't':
+        case 'n':
+        case 'l':
+        case 'L':
+        case 'v':
+        case '^':
+        case '$':
+        case 's':
+        case 'g':
+        case '#':
+        case '!':
+        case '%':
+            return true;
+        default:
+            return false;
+    }
+}
+
+constexpr bool is_tm_flag(char flag) {
+    switch (flag) {
+        case 'Y':
+        case 'C':
+        case 'm':
+        case 'd':
+        case 'H':
+        case 'M':
+        case 'S':
+        case 'D':
+        case 'T':
+        case 'R':
+            return true;
+        default:
+            return false;
+    }
+}
+
+template <fixed_string Pattern>
+constexpr bool is_valid_pattern() {
+    for (size_t i = 0; i < Pattern.size(); i++) {
+        if (Pattern[i] != '%') {
+            continue;
+        }
+        if (++i == Pattern.size()) {
+            break;  // trailing '%' is ignored, as in pattern_formatter
+        }
+        if (!is_supported_flag(Pattern[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <fixed_string Pattern>
+constexpr auto parse_pattern() {
+    pattern<Pattern.size() + 1> result{};
+    size_t literals_size = 0;
+    bool in_literal = false;
+
+    auto add_literal = [&](char ch) {
+        if (!in_literal) {
+            result.tokens[result.token_count++] = token{0, literals_size, 0};
+            in_literal = true;
+        }
+        result.literals[literals_size++] = ch;
+        result.tokens[result.token_count - 1].size++;
+    };
+
+    for (size_t i = 0; i < Pattern.size(); i++) {
+        if (Pattern[i] != '%') {
+            add_literal(Pattern[i]);
+            continue;
+        }
+        if (++i == Pattern.size()) {
+            break;
+        }
+        const char flag = Pattern[i];
+        if (flag == '%') {
+            add_literal('%');
+            continue;
+        }
+        in_literal = false;
+        result.tokens[result.token_count++] = token{flag, 0, 0};
+    }
+
+    // group the runs of literals and tm flags which have at least one tm flag
+    for (size_t i = 0; i < result.token_count;) {
+        size_t end = i;
+        bool has_tm = false;
+        while (end < result.token_count &&
+               (result.tokens[end].flag == 0 || is_tm_flag(result.tokens[end].flag))) {
+            has_tm = has_tm || result.tokens[end].flag != 0;
+            end++;
+        }
+        if (has_tm) {
+            result.steps[result.step_count++] =
+                token{datetime_flag, i, end - i, result.group_count++};
+            i = end;
+        } else {
+            result.steps[result.step_count++] = result.tokens[i++];
+        }
+    }
+    return result;
+}
+
+inline const char *basename(const char *filename) {
+    const char *base = filename;
+    for (const char *p = filename; *p != '\0'; p++) {
+        if (std::strchr(os::folder_seps, *p) != nullptr) {
+            base = p + 1;
+        }
+    }
+    return base;
+}
+
+}  // namespace compiled
+}  // namespace details
+
+template <details::compiled::fixed_string Pattern>
+class compiled_formatter final : public formatter {
+    static_assert(details::compiled::is_valid_pattern<Pattern>(),
+                  "compiled_formatter: unsupported flag or padding in pattern");
+
+public:
+    explicit compiled_formatter(pattern_time_type time_type = pattern_time_type::local,
+                                std::string eol = spdlog::details::os::default_eol)
+        : eol_(std::move(eol)),
+          pattern_time_type_(time_type) {
+        std::memset(&cached_tm_, 0, sizeof(cached_tm_));
+    }
+
+    compiled_formatter(const compiled_formatter &other) = delete;
+    compiled_formatter &operator=(const compiled_formatter &other) = delete;
+
+    std::unique_ptr<formatter> clone() const override {
+        return details::make_unique<compiled_formatter>(pattern_time_type_, eol_);
+    }
+
+    void format(const details::log_msg &msg, memory_buf_t &dest) override {
+        if constexpr (pattern_.group_count > 0) {
+            const auto secs =
+                std::chrono::duration_cast<std::chrono::seconds>(msg.time.time_since_epoch());
+            if (secs != last_log_secs_) {
+                const auto t = log_clock::to_time_t(msg.time);
+                cached_tm_ = pattern_time_type_ == pattern_time_type::local
+                                 ? details::tz_cache::instance().localtime(t)
+                                 : details::tz_cache::instance().gmtime(t);
+                last_log_secs_ = secs;
+                render_groups_(msg, std::make_index_sequence<pattern_.step_count>{});
+            }
+        }
+        format_steps_(msg, dest, std::make_index_sequence<pattern_.step_count>{});
+        details::fmt_helper::append_string_view(eol_, dest);
+    }
+
+private:
+    static constexpr auto pattern_ = details::compiled::parse_pattern<Pattern>();
+
+    std::string eol_;
+    pattern_time_type pattern_time_type_;
+    std::tm cached_tm_;
+    std::chrono::seconds last_log_secs_{-1};
+    std::array<memory_buf_t, pattern_.group_count> cached_datetime_;
+
+    template <size_t... I>
+    void format_steps_(const details::log_msg &msg, memory_buf_t &dest, std::index_sequence<I...>) {
+        (format_step_<pattern_.steps[I]>(msg, dest), ...);
+    }
+
+    template <details::compiled::token Step>
+    void format_step_(const details::log_msg &msg, memory_buf_t &dest) {
+        if constexpr (Step.flag == details::compiled::datetime_flag) {
+            const memory_buf_t &text = cached_datetime_[Step.group];
+            dest.append(text.begin(), text.end());
+        } else {
+            format_token_<Step>(msg, dest);
+        }
+    }
+
+    template <size_t... I>
+    void render_groups_(const details::log_msg &msg, std::index_sequence<I...>) {
+        (render_group_<pattern_.steps[I]>(msg), ...);
+    }
+
+    template <details::compiled::token Step>
+    void render_group_(const details::log_msg &msg) {
+        if constexpr (Step.flag == details::compiled::datetime_flag) {
+            memory_buf_t &text = cached_datetime_[Step.group];
+            text.clear();
+            render_tokens_<Step.offset>(msg, text, std::make_index_sequence<Step.size>{});
+        }
+    }
+
+    template <size_t Offset, size_t... I>
+    void render_tokens_(const details::log_msg &msg,
+                        memory_buf_t &dest,
+                        std::index_sequence<I...>) {
+        (format_token_<pattern_.tokens[Offset + I]>(msg, dest), ...);
+    }
+
+    template <details::compiled::token Token>
+    void format_token_(const details::log_msg &msg, memory_buf_t &dest) {
+        using namespace details;
+        using std::chrono::microseconds;
+        using std::chrono::milliseconds;
+        using std::chrono::nanoseconds;
+        const std::tm &tm_time = cached_tm_;
+
+        if constexpr (Token.flag == 0) {
+            if constexpr (Token.size == 1) {
+                dest.push_back(pattern_.literals[Token.offset]);
+            } else {
+                const char *begin = pattern_.literals.data() + Token.offset;
+                dest.append(begin, begin + Token.size);
+            }
+        } else if constexpr (Token.flag == 'Y') {
+            fmt_helper::append_int(tm_time.tm_year + 1900, dest);
+        } else if constexpr (Token.flag == 'C') {
+            fmt_helper::pad2(tm_time.tm_year % 100, dest);
+        } else if constexpr (Token.flag == 'm') {
+            fmt_helper::pad2(tm_time.tm_mon + 1, dest);
+        } else if constexpr (Token.flag == 'd') {
+            fmt_helper::pad2(tm_time.tm_mday, dest);
+        } else if constexpr (Token.flag == 'H') {
+            fmt_helper::pad2(tm_time.tm_hour, dest);
+        } else if constexpr (Token.flag == 'M') {
+            fmt_helper::pad2(tm_time.tm_min, dest);
+        } else if constexpr (Token.flag == 'S') {
+            fmt_helper::pad2(tm_time.tm_sec, dest);
+        } else if constexpr (Token.flag == 'e') {
+            auto millis = fmt_helper::time_fraction<milliseconds>(msg.time);
+            fmt_helper::pad3(static_cast<uint32_t>(millis.count()), dest);
+        } else if constexpr (Token.flag == 'f') {
+            auto micros = fmt_helper::time_fraction<microseconds>(msg.time);
+            fmt_helper::pad6(static_cast<size_t>(micros.count()), dest);
+        } else if constexpr (Token.flag == 'F') {
+            auto ns = fmt_helper::time_fraction<nanoseconds>(msg.time);
+            fmt_helper::pad9(static_cast<size_t>(ns.count()), dest);
+        } else if constexpr (Token.flag == 'E') {
+            auto duration = msg.time.time_since_epoch();
+            auto seconds = std::chrono::duration_cast<std::chrono::seconds>(duration).count();
+            fmt_helper::append_int(seconds, dest);
+        } else if constexpr (Token.flag == 'D') {
+            fmt_helper::pad2(tm_time.tm_mon + 1, dest);
+            dest.push_back('/');
+            fmt_helper::pad2(tm_time.tm_mday, dest);
+            dest.push_back('/');
+            fmt_helper::pad2(tm_time.tm_year % 100, dest);
+        } else if constexpr (Token.flag == 'T') {
+            fmt_helper::pad2(tm_time.tm_hour, dest);
+            dest.push_back(':');
+            fmt_helper::pad2(tm_time.tm_min, dest);
+            dest.push_back(':');
+            fmt_helper::pad2(tm_time.tm_sec, dest);
+        } else if constexpr (Token.flag == 'R') {
+            fmt_helper::pad2(tm_time.tm_hour, dest);
+            dest.push_back(':');
+            fmt_helper::pad2(tm_time.tm_min, dest);
+        } else if constexpr (Token.flag == 'P') {
+            fmt_helper::append_string_view(pid_text::get(), dest);
+        } else if constexpr (Token.flag == 't') {
+    #ifndef SPDLOG_NO_TLS
+            fmt_helper::append_string_view(thread_id_text(msg.thread_id), dest);
+    #else
+            fmt_helper::append_int(msg.thread_id, dest);
+    #endif
+        } else if constexpr (Token.flag == 'n') {
+            fmt_helper::append_string_view(msg.logger_name, dest);
+        } else if constexpr (Token.flag == 'l') {
+            fmt_helper::append_string_view(level::to_string_view(msg.level), dest);
+        } else if constexpr (Token.flag == 'L') {
+            fmt_helper::append_string_view(level::to_short_c_str(msg.level), dest);
+        } else if constexpr (Token.flag == 'v') {
+            fmt_helper::append_string_view(msg.payload, dest);
+        } else if constexpr (Token.flag == '^') {
+            msg.color_range_start = dest.size();
+        } else if constexpr (Token.flag == '$') {
+            msg.color_range_end = dest.size();
+        } else if constexpr (Token.flag == 's') {
+            if (!msg.source.empty()) {
+                fmt_helper::append_string_view(compiled::basename(msg.source.filename), dest);
+            }
+        } else if constexpr (Token.flag == 'g') {
+            if (!msg.source.empty()) {
+                fmt_helper::append_string_view(msg.source.filename, dest);
+            }
+        } else if constexpr (Token.flag == '#') {
+            if (!msg.source.empty()) {
+                fmt_helper::append_int(msg.source.line, dest);
+            }
+        } else if constexpr (Token.flag == '!') {
+            if (!msg.source.empty()) {
+                fmt_helper::append_string_view(msg.source.funcname, dest);
+            }
+        }
+    }
+};
+
+}  // namespace spdlog
+
+#endif
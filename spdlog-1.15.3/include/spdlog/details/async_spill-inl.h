@@ -0,0 +1,192 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#ifndef SPDLOG_HEADER_ONLY
+    #include <spdlog/details/async_spill.h>
+#endif
+
+#include <spdlog/details/os.h>
+#include <spdlog/details/thread_pool.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace spdlog {
+namespace details {
+
+// fixed size part of a spill record, followed by the logger name and the payload.
+// records are 8 bytes aligned in the file.
+struct async_spill::record_header {
+    uint32_t size;  // of the whole record, including padding
+    uint8_t msg_type;
+    uint8_t level;
+    uint16_t logger_name_size;
+    uint32_t payload_size;
+    uint32_t source_line;
+    uint64_t logger_slot;
+    int64_t time;          // log_clock ticks since epoch
+    uint64_t ticks;        // log_msg::ticks
+    int64_t enqueue_time;  // steady_clock ticks
+    uint64_t thread_id;
+    uint64_t source_filename;  // addresses of static strings
+    uint64_t source_funcname;
+};
+
+SPDLOG_INLINE async_spill::async_spill(const filename_t &fname, size_t max_bytes) {
+    if (max_bytes < sizeof(record_header) + 8) {
+        throw_spdlog_ex("async spill: spill file too small");
+    }
+    file_.open(fname, max_bytes);
+}
+
+SPDLOG_INLINE async_spill::~async_spill() {
+    auto fname = file_.filename();
+    file_.close();
+    os::remove_if_exists(fname);
+}
+
+SPDLOG_INLINE bool async_spill::append(async_msg_type msg_type,
+                                       size_t logger_slot,
+                                       std::chrono::steady_clock::time_point enqueue_time,
+                                       const log_msg &msg) {
+    // truncate what doesn't fit in the whole file
+    const size_t max_record_size =
+        (std::min)(file_.size(), size_t{UINT32_MAX}) & ~static_cast<size_t>(7);
+    const size_t room = max_record_size - sizeof(record_header);
+    const auto name_size = (std::min)({msg.logger_name.size(), size_t{UINT16_MAX}, room});
+    const auto payload_size = (std::min)(msg.payload.size(), room - name_size);
+    const size_t record_size =
+        (sizeof(record_header) + name_size + payload_size + 7) & ~static_cast<size_t>(7);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    size_t offset = free_offset_(record_size);
+    while (offset == static_cast<size_t>(-1)) {
+        consumed_cv_.wait(lock);
+        offset = free_offset_(record_size);
+    }
+    if (offset < write_offset_) {
+        wrap_offset_ = write_offset_;
+        wrapped_ = true;
+    }
+
+    record_header header{};
+    header.size = static_cast<uint32_t>(record_size);
+    header.msg_type = static_cast<uint8_t>(msg_type);
+    header.level = static_cast<uint8_t>(msg.level);
+    header.logger_name_size = static_cast<uint16_t>(name_size);
+    header.payload_size = static_cast<uint32_t>(payload_size);
+    header.source_line = static_cast<uint32_t>(msg.source.line);
+    header.logger_slot = logger_slot;
+    header.time = static_cast<int64_t>(msg.time.time_since_epoch().count());
+    header.ticks = msg.ticks;
+    header.enqueue_time = static_cast<int64_t>(enqueue_time.time_since_epoch().count());
+    header.thread_id = msg.thread_id;
+    header.source_filename = reinterpret_cast<uintptr_t>(msg.source.filename);
+    header.source_funcname = reinterpret_cast<uintptr_t>(msg.source.funcname);
+
+    char *dest = file_.data() + offset;
+    std::memcpy(dest, &header, sizeof(header));
+    dest += sizeof(header);
+    std::memcpy(dest, msg.logger_name.data(), name_size);
+    dest += name_size;
+    std::memcpy(dest, msg.payload.data(), payload_size);
+
+    const bool was_empty = appended_ == consumed_;
+    write_offset_ = offset + record_size;
+    appended_++;
+    active_.store(true, std::memory_order_release);
+    return was_empty;
+}
+
+SPDLOG_INLINE size_t async_spill::free_offset_(size_t record_size) const {
+    const size_t npos = static_cast<size_t>(-1);
+    if (wrapped_) {
+        return write_offset_ + record_size <= read_offset_ ? write_offset_ : npos;
+    }
+    if (write_offset_ + record_size <= file_.size()) {
+        return write_offset_;
+    }
+    // back to the start of the file, ahead of the oldest record
+    return record_size <= read_offset_ ? 0 : npos;
+}
+
+SPDLOG_INLINE bool async_spill::try_begin_replay() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (replaying_) {
+        return false;
+    }
+    replaying_ = true;
+    return true;
+}
+
+SPDLOG_INLINE void async_spill::end_replay() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    replaying_ = false;
+}
+
+// the record bytes stay valid without holding the lock: writers only write where
+// consumed records were, and only the replaying thread consumes.
+SPDLOG_INLINE bool async_spill::peek(record &rec) {
+    const char *src;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (appended_ == consumed_) {
+            return false;
+        }
+        src = file_.data() + read_offset_;
+    }
+
+    record_header header;
+    std::memcpy(&header, src, sizeof(header));
+    src += sizeof(header);
+    rec.msg_type = static_cast<async_msg_type>(header.msg_type);
+    rec.logger_slot = static_cast<size_t>(header.logger_slot);
+    rec.enqueue_time = std::chrono::steady_clock::time_point(
+        std::chrono::steady_clock::duration(header.enqueue_time));
+    rec.msg.logger_name = string_view_t(src, header.logger_name_size);
+    rec.msg.payload = string_view_t(src + header.logger_name_size, header.payload_size);
+    rec.msg.level = static_cast<level::level_enum>(header.level);
+    rec.msg.time = log_clock::time_point(log_clock::duration(header.time));
+    rec.msg.ticks = header.ticks;
+    rec.msg.thread_id = static_cast<size_t>(header.thread_id);
+    rec.msg.source = source_loc{reinterpret_cast<const char *>(header.source_filename),
+                                static_cast<int>(header.source_line),
+                                reinterpret_cast<const char *>(header.source_funcname)};
+    rec.msg.color_range_start = 0;
+    rec.msg.color_range_end = 0;
+    return true;
+}
+
+SPDLOG_INLINE void async_spill::consume() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        record_header header;
+        std::memcpy(&header, file_.data() + read_offset_, sizeof(header));
+        read_offset_ += header.size;
+        consumed_++;
+        if (wrapped_ && read_offset_ == wrap_offset_) {
+            read_offset_ = 0;
+            wrapped_ = false;
+        }
+        if (appended_ == consumed_) {
+            read_offset_ = write_offset_ = 0;
+            active_.store(false, std::memory_order_release);
+        }
+    }
+    consumed_cv_.notify_all();
+}
+
+SPDLOG_INLINE uint64_t async_spill::appended() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return appended_;
+}
+
+SPDLOG_INLINE uint64_t async_spill::consumed() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return consumed_;
+}
+
+}  // namespace details
+}  // namespace spdlog
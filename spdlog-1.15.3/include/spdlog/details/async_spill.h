@@ -0,0 +1,91 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <spdlog/details/log_msg.h>
+#include <spdlog/details/mmap_file.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+namespace spdlog {
+namespace details {
+
+enum class async_msg_type;
+
+// Overflow storage of a thread pool for async_overflow_policy::spill_to_disk.
+// Records that do not fit in the queue are appended in a compact binary form to a
+// memory mapped file, and are replayed in order by a worker once the queue drained.
+// The file is used as a ring: a record that doesn't fit before the end of the file goes to
+// its start, once enough records were replayed there. Records larger than the whole file
+// are truncated to fit it.
+// Records reference loggers by thread pool slot and source locations by address, so a
+// spill file is only meaningful to the process that wrote it.
+class SPDLOG_API async_spill {
+public:
+    struct record {
+        async_msg_type msg_type;
+        size_t logger_slot;
+        std::chrono::steady_clock::time_point enqueue_time;
+        log_msg msg;  // string views point into the mapping
+    };
+
+    async_spill(const filename_t &fname, size_t max_bytes);
+    async_spill(const async_spill &) = delete;
+    async_spill &operator=(const async_spill &) = delete;
+    ~async_spill();
+
+    // true while records are pending. new msgs must then be spilled too, to keep the order.
+    bool active() const { return active_.load(std::memory_order_acquire); }
+
+    // append a record, blocking while the file has no room for it.
+    // return true if the spill was empty before (a worker must be woken up to replay it).
+    bool append(async_msg_type msg_type,
+                size_t logger_slot,
+                std::chrono::steady_clock::time_point enqueue_time,
+                const log_msg &msg);
+
+    // only one thread replays at a time: try_begin_replay() returns false if another does.
+    bool try_begin_replay();
+    void end_replay();
+
+    // read the oldest record without consuming it. return false if there is none.
+    bool peek(record &rec);
+    // drop the record returned by peek()
+    void consume();
+
+    // number of records appended / consumed so far
+    uint64_t appended();
+    uint64_t consumed();
+
+private:
+    struct record_header;
+
+    // where a record of that size fits, npos if there is no room for it
+    size_t free_offset_(size_t record_size) const;
+
+    mmap_file file_;
+    std::mutex mutex_;
+    std::condition_variable consumed_cv_;
+    std::atomic<bool> active_{false};
+    bool replaying_ = false;
+    // the records are in [read_offset_, write_offset_), or, once a record went back to the
+    // start of the file, in [read_offset_, wrap_offset_) followed by [0, write_offset_)
+    size_t read_offset_ = 0;
+    size_t write_offset_ = 0;
+    size_t wrap_offset_ = 0;
+    bool wrapped_ = false;
+    uint64_t appended_ = 0;
+    uint64_t consumed_ = 0;
+};
+
+}  // namespace details
+}  // namespace spdlog
+
+#ifdef SPDLOG_HEADER_ONLY
+    #include "async_spill-inl.h"
+#endif
@@ -0,0 +1,268 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+//
+// Binary log file format written by sinks::binary_file_sink and read by the
+// spdlog-decode tool.
+//
+// file    := header block*
+// header  := magic[8] version[1] reserved[7]      (may repeat, e.g. when appending)
+// block   := sync record*
+// sync    := sync_marker[8] time[8]               (little endian ns since epoch)
+// record  := 0x01 id text                         (defines string id of this block)
+//          | 0x02 time_delta level logger thread file line func payload
+//
+// Integers are LEB128 varints, time_delta is zigzag encoded and relative to
+// the previous record (or the sync time). logger/file/func are string ids,
+// id 0 means "none". text and payload are a varint length followed by the
+// bytes. The string table restarts at every sync marker, so decoding can
+// resume at the next marker after a damaged or truncated region.
+//
+
+#include <spdlog/common.h>
+#include <spdlog/details/log_msg.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace spdlog {
+namespace details {
+namespace binary_log {
+
+static const char magic[8] = {'\x89', 'S', 'P', 'D', 'L', 'O', 'G', '\n'};
+static const char sync_marker[8] = {'\xff', 'S', 'Y', 'N', 'C', '\xa5', '\x5a', '\xff'};
+static const uint8_t version = 1;
+static const size_t header_size = 16;
+
+static const uint8_t tag_string = 0x01;
+static const uint8_t tag_message = 0x02;
+
+inline void write_varint(uint64_t value, memory_buf_t &dest) {
+    while (value >= 0x80) {
+        dest.push_back(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    dest.push_back(static_cast<char>(value));
+}
+
+inline void write_fixed64(uint64_t value, memory_buf_t &dest) {
+    for (int i = 0; i < 8; i++) {
+        dest.push_back(static_cast<char>((value >> (i * 8)) & 0xff));
+    }
+}
+
+inline void write_bytes(string_view_t bytes, memory_buf_t &dest) {
+    write_varint(bytes.size(), dest);
+    const auto old_size = dest.size();
+    dest.resize(old_size + bytes.size());
+    std::memcpy(dest.data() + old_size, bytes.data(), bytes.size());
+}
+
+inline uint64_t zigzag(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+inline int64_t unzigzag(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+inline int64_t to_nanos(log_clock::time_point tp) {
+    return static_cast<int64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(tp.time_since_epoch()).count());
+}
+
+inline void write_header(memory_buf_t &dest) {
+    dest.append(magic, magic + sizeof(magic));
+    dest.push_back(static_cast<char>(version));
+    for (size_t i = sizeof(magic) + 1; i < header_size; i++) {
+        dest.push_back('\0');
+    }
+}
+
+inline void write_sync(int64_t time_ns, memory_buf_t &dest) {
+    dest.append(sync_marker, sync_marker + sizeof(sync_marker));
+    write_fixed64(static_cast<uint64_t>(time_ns), dest);
+}
+
+//
+// Decodes a memory range holding (part of) a binary log file.
+// next() returns false at the end of the range; the returned message refers to
+// reader owned strings and stays valid until the following call. Damaged regions
+// are skipped up to the next sync marker; skipped_bytes() tells how much was lost.
+//
+class reader {
+public:
+    reader(const char *begin, const char *end)
+        : pos_(begin),
+          end_(end) {}
+
+    bool next(log_msg &msg) {
+        while (pos_ < end_) {
+            const char *record_start = pos_;
+            if (read_record_(msg)) {
+                return true;
+            }
+            if (pos_ == record_start) {
+                // damaged: resume at the next sync marker
+                recover_(record_start + 1);
+            }
+        }
+        return false;
+    }
+
+    size_t skipped_bytes() const { return skipped_; }
+    bool bad_version() const { return bad_version_; }
+
+private:
+    const char *pos_;
+    const char *end_;
+    std::vector<std::string> strings_{std::string()};  // id 0 is the empty string
+    int64_t last_time_ = 0;
+    bool synced_ = false;
+    size_t skipped_ = 0;
+    bool bad_version_ = false;
+
+    // returns true if msg was filled. pos_ is left unchanged on damaged input.
+    bool read_record_(log_msg &msg) {
+        const char *p = pos_;
+        const auto tag = static_cast<uint8_t>(*p);
+
+        if (tag == static_cast<uint8_t>(magic[0])) {
+            if (static_cast<size_t>(end_ - p) < header_size || !matches_(p, magic, sizeof(magic))) {
+                return false;
+            }
+            if (static_cast<uint8_t>(p[sizeof(magic)]) != version) {
+                // written by a newer version, the records can't be trusted
+                bad_version_ = true;
+                pos_ = end_;
+                return false;
+            }
+            synced_ = false;
+            pos_ = p + header_size;
+            return false;
+        }
+
+        if (tag == static_cast<uint8_t>(sync_marker[0])) {
+            if (!matches_(p, sync_marker, sizeof(sync_marker)) || end_ - p < 16) {
+                return false;
+            }
+            p += sizeof(sync_marker);
+            uint64_t time_ns = 0;
+            for (int i = 0; i < 8; i++) {
+                time_ns |= static_cast<uint64_t>(static_cast<uint8_t>(p[i])) << (i * 8);
+            }
+            last_time_ = static_cast<int64_t>(time_ns);
+            strings_.resize(1);
+            synced_ = true;
+            pos_ = p + 8;
+            return false;
+        }
+
+        if (!synced_) {
+            return false;
+        }
+        p++;
+
+        if (tag == tag_string) {
+            uint64_t id;
+            string_view_t text;
+            if (!read_varint_(p, id) || !read_bytes_(p, text) || id != strings_.size()) {
+                return false;
+            }
+            strings_.emplace_back(text.data(), text.size());
+            pos_ = p;
+            return false;
+        }
+
+        if (tag == tag_message) {
+            uint64_t delta, lvl, logger, thread, file, line, func;
+            string_view_t payload;
+            if (!read_varint_(p, delta) || p == end_) {
+                return false;
+            }
+            lvl = static_cast<uint8_t>(*p++);
+            if (lvl >= static_cast<uint64_t>(level::n_levels) || !read_varint_(p, logger) ||
+                !read_varint_(p, thread) || !read_varint_(p, file) || !read_varint_(p, line) ||
+                !read_varint_(p, func) || !read_bytes_(p, payload) ||
+                logger >= strings_.size() || file >= strings_.size() ||
+                func >= strings_.size()) {
+                return false;
+            }
+            last_time_ += unzigzag(delta);
+            msg = log_msg();
+            msg.time = log_clock::time_point(std::chrono::duration_cast<log_clock::duration>(
+                std::chrono::nanoseconds(last_time_)));
+            msg.level = static_cast<level::level_enum>(lvl);
+            msg.logger_name = strings_[static_cast<size_t>(logger)];
+            msg.thread_id = static_cast<size_t>(thread);
+            if (file != 0) {
+                msg.source = source_loc{strings_[static_cast<size_t>(file)].c_str(),
+                                        static_cast<int>(line),
+                                        func != 0 ? strings_[static_cast<size_t>(func)].c_str()
+                                                  : nullptr};
+            }
+            msg.payload = payload;
+            pos_ = p;
+            return true;
+        }
+        return false;
+    }
+
+    void recover_(const char *from) {
+        const char *p = from;
+        for (; p < end_; p++) {
+            if ((*p == sync_marker[0] && matches_(p, sync_marker, sizeof(sync_marker))) ||
+                (*p == magic[0] && matches_(p, magic, sizeof(magic)))) {
+                break;
+            }
+        }
+        skipped_ += static_cast<size_t>(p - pos_);
+        pos_ = p;
+        synced_ = false;
+    }
+
+    bool matches_(const char *p, const char *bytes, size_t n) const {
+        return static_cast<size_t>(end_ - p) >= n && std::memcmp(p, bytes, n) == 0;
+    }
+
+    bool read_varint_(const char *&p, uint64_t &value) const {
+        value = 0;
+        for (int shift = 0; shift < 64 && p < end_; shift += 7) {
+            const auto byte = static_cast<uint8_t>(*p++);
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool read_bytes_(const char *&p, string_view_t &bytes) const {
+        uint64_t size;
+        if (!read_varint_(p, size) || size > static_cast<uint64_t>(end_ - p)) {
+            return false;
+        }
+        bytes = string_view_t(p, static_cast<size_t>(size));
+        // a length read from damaged data tends to swallow the following blocks
+        const char *bytes_end = p + size;
+        const char *q = p;
+        while ((q = static_cast<const char *>(
+                    std::memchr(q, sync_marker[0], static_cast<size_t>(bytes_end - q)))) != nullptr) {
+            if (matches_(q, sync_marker, sizeof(sync_marker))) {
+                return false;
+            }
+            q++;
+        }
+        p += size;
+        return true;
+    }
+};
+
+}  // namespace binary_log
+}  // namespace details
+}  // namespace spdlog
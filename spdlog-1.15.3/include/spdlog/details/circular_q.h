@@ -84,6 +84,9 @@ public:
 
     bool empty() const { return tail_ == head_; }
 
+    // max number of elements (0 for a disabled queue)
+    size_t capacity() const { return max_items_ > 0 ? max_items_ - 1 : 0; }
+
     bool full() const {
         // head is ahead of the tail by 1
         if (max_items_ > 0) {
@@ -13,6 +13,7 @@
 #include <cerrno>
 #include <chrono>
 #include <cstdio>
+#include <cstring>
 #include <string>
 #include <thread>
 #include <tuple>
@@ -53,6 +54,27 @@ SPDLOG_INLINE void file_helper::open(const filename_t &fname, bool truncate) {
             if (event_handlers_.after_open) {
                 event_handlers_.after_open(filename_, fd_);
             }
+#ifdef SPDLOG_FILE_BUFFER_SIZE
+            // whatever after_open wrote must go before our own writes
+            std::fflush(fd_);
+            buffered_ = 0;
+            file_size_ = os::filesize(fd_);
+    #ifdef SPDLOG_HAS_IO_URING
+            if (!uring_ && !buffer_) {
+                uring_.reset(new uring_writer(SPDLOG_FILE_BUFFER_SIZE, 4));
+                if (!uring_->ok()) {
+                    uring_.reset();
+                }
+            }
+            if (uring_) {
+                uring_->set_fd(::fileno(fd_));
+                return;
+            }
+    #endif
+            if (!buffer_) {
+                buffer_.reset(new char[SPDLOG_FILE_BUFFER_SIZE]);
+            }
+#endif
             return;
         }
 
@@ -71,22 +93,58 @@ SPDLOG_INLINE void file_helper::reopen(bool truncate) {
 }
 
 SPDLOG_INLINE void file_helper::flush() {
+#ifdef SPDLOG_FILE_BUFFER_SIZE
+    flush_buffer_();
+#endif
     if (std::fflush(fd_) != 0) {
         throw_spdlog_ex("Failed flush to file " + os::filename_to_str(filename_), errno);
     }
 }
 
 SPDLOG_INLINE void file_helper::sync() {
+#ifdef SPDLOG_HAS_IO_URING
+    if (uring_) {
+        if (!uring_->sync()) {
+            throw_spdlog_ex("Failed to fsync file " + os::filename_to_str(filename_), errno);
+        }
+        return;
+    }
+#endif
+#ifdef SPDLOG_FILE_BUFFER_SIZE
+    flush_buffer_();
+#endif
     if (!os::fsync(fd_)) {
         throw_spdlog_ex("Failed to fsync file " + os::filename_to_str(filename_), errno);
     }
 }
 
+SPDLOG_INLINE void file_helper::datasync() {
+    if (!os::fdatasync(fd_)) {
+        throw_spdlog_ex("Failed to fdatasync file " + os::filename_to_str(filename_), errno);
+    }
+}
+
+SPDLOG_INLINE void file_helper::preallocate(size_t offset, size_t len) {
+    // best effort: without it the file just grows as usual
+    if (fd_ != nullptr && os::preallocate(fd_, offset, len)) {
+        preallocated_ = true;
+    }
+}
+
 SPDLOG_INLINE void file_helper::close() {
     if (fd_ != nullptr) {
+#ifdef SPDLOG_FILE_BUFFER_SIZE
+        SPDLOG_TRY { flush_buffer_(); }
+        SPDLOG_CATCH_STD
+#endif
         if (event_handlers_.before_close) {
             event_handlers_.before_close(filename_, fd_);
         }
+        if (preallocated_) {
+            std::fflush(fd_);
+            os::release_preallocated(fd_);
+            preallocated_ = false;
+        }
 
         std::fclose(fd_);
         fd_ = nullptr;
@@ -102,16 +160,68 @@ SPDLOG_INLINE void file_helper::write(const memory_buf_t &buf) {
     size_t msg_size = buf.size();
     auto data = buf.data();
 
+#ifdef SPDLOG_FILE_BUFFER_SIZE
+    #ifdef SPDLOG_HAS_IO_URING
+    if (uring_) {
+        file_size_ += msg_size;
+        if (!uring_->write(data, msg_size)) {
+            throw_spdlog_ex("Failed writing to file " + os::filename_to_str(filename_), errno);
+        }
+        return;
+    }
+    #endif
+    const size_t capacity = SPDLOG_FILE_BUFFER_SIZE;
+    if (msg_size > capacity - buffered_) {
+        if (msg_size >= capacity) {
+            // too big to buffer: write it together with what is pending
+            if (!os::write_direct(fd_, buffer_.get(), buffered_, data, msg_size)) {
+                throw_spdlog_ex("Failed writing to file " + os::filename_to_str(filename_), errno);
+            }
+            buffered_ = 0;
+            file_size_ += msg_size;
+            return;
+        }
+        flush_buffer_();
+    }
+    std::memcpy(buffer_.get() + buffered_, data, msg_size);
+    buffered_ += msg_size;
+    file_size_ += msg_size;
+#else
     if (!details::os::fwrite_bytes(data, msg_size, fd_)) {
         throw_spdlog_ex("Failed writing to file " + os::filename_to_str(filename_), errno);
     }
+#endif
 }
 
 SPDLOG_INLINE size_t file_helper::size() const {
     if (fd_ == nullptr) {
         throw_spdlog_ex("Cannot use size() on closed file " + os::filename_to_str(filename_));
     }
+#ifdef SPDLOG_FILE_BUFFER_SIZE
+    return file_size_;
+#else
     return os::filesize(fd_);
+#endif
+}
+
+SPDLOG_INLINE void file_helper::flush_buffer_() {
+#ifdef SPDLOG_HAS_IO_URING
+    if (uring_) {
+        if (!uring_->flush()) {
+            throw_spdlog_ex("Failed writing to file " + os::filename_to_str(filename_), errno);
+        }
+        return;
+    }
+#endif
+    if (buffered_ == 0) {
+        return;
+    }
+    // on failure the pending bytes are dropped, like a failed fwrite
+    const auto pending = buffered_;
+    buffered_ = 0;
+    if (!os::write_direct(fd_, buffer_.get(), pending)) {
+        throw_spdlog_ex("Failed writing to file " + os::filename_to_str(filename_), errno);
+    }
 }
 
 SPDLOG_INLINE const filename_t &file_helper::filename() const { return filename_; }
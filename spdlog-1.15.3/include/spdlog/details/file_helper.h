@@ -4,6 +4,8 @@
 #pragma once
 
 #include <spdlog/common.h>
+#include <spdlog/details/uring_writer.h>
+#include <memory>
 #include <tuple>
 
 namespace spdlog {
@@ -12,6 +14,9 @@ namespace details {
 // Helper class for file sinks.
 // When failing to open a file, retry several times(5) with a delay interval(10 ms).
 // Throw spdlog_ex exception on errors.
+// With SPDLOG_FILE_BUFFER_SIZE defined, writes are collected in an own buffer
+// and written straight to the file descriptor, and size() doesn't stat the file.
+// With SPDLOG_FILE_IO_URING too, the writes go through io_uring when available.
 
 class SPDLOG_API file_helper {
 public:
@@ -26,6 +31,12 @@ public:
     void reopen(bool truncate);
     void flush();
     void sync();
+    // fdatasync what was flushed so far. doesn't touch the pending writes, so
+    // unlike sync() it may run while another thread writes.
+    void datasync();
+    // reserve disk space for [offset, offset + len) (see os::preallocate).
+    // what wasn't used is given back on close.
+    void preallocate(size_t offset, size_t len);
     void close();
     void write(const memory_buf_t &buf);
     size_t size() const;
@@ -52,6 +63,17 @@ private:
     std::FILE *fd_{nullptr};
     filename_t filename_;
     file_event_handlers event_handlers_;
+    bool preallocated_ = false;
+
+    // SPDLOG_FILE_BUFFER_SIZE only
+    std::unique_ptr<char[]> buffer_;
+    size_t buffered_ = 0;
+    size_t file_size_ = 0;  // including the buffered bytes
+#ifdef SPDLOG_HAS_IO_URING
+    std::unique_ptr<uring_writer> uring_;  // null if io_uring isn't available
+#endif
+
+    void flush_buffer_();
 };
 }  // namespace details
 }  // namespace spdlog
@@ -81,11 +81,22 @@ inline unsigned int count_digits(T n) {
 #endif
 }
 
+// two ascii digits of the given value (0-99), so the common date/time fields
+// are rendered with one table lookup instead of a division per digit.
+inline const char *digits2(size_t value) {
+    static const char table[] =
+        "00010203040506070809101112131415161718192021222324"
+        "25262728293031323334353637383940414243444546474849"
+        "50515253545556575859606162636465666768697071727374"
+        "75767778798081828384858687888990919293949596979899";
+    return &table[value * 2];
+}
+
 inline void pad2(int n, memory_buf_t &dest) {
     if (n >= 0 && n < 100)  // 0-99
     {
-        dest.push_back(static_cast<char>('0' + n / 10));
-        dest.push_back(static_cast<char>('0' + n % 10));
+        const char *d = digits2(static_cast<size_t>(n));
+        dest.append(d, d + 2);
     } else  // unlikely, but just in case, let fmt deal with it
     {
         fmt_lib::format_to(std::back_inserter(dest), SPDLOG_FMT_STRING("{:02}"), n);
@@ -106,9 +117,8 @@ inline void pad3(T n, memory_buf_t &dest) {
     static_assert(std::is_unsigned<T>::value, "pad3 must get unsigned T");
     if (n < 1000) {
         dest.push_back(static_cast<char>(n / 100 + '0'));
-        n = n % 100;
-        dest.push_back(static_cast<char>((n / 10) + '0'));
-        dest.push_back(static_cast<char>((n % 10) + '0'));
+        const char *d = digits2(static_cast<size_t>(n % 100));
+        dest.append(d, d + 2);
     } else {
         append_int(n, dest);
     }
@@ -0,0 +1,78 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+// Cached text of the pid and of thread ids, for the %P and %t flags of the formatters.
+
+#include <spdlog/common.h>
+#include <spdlog/details/os.h>
+
+#include <cstring>
+
+#ifndef _WIN32
+    #include <pthread.h>
+#endif
+
+namespace spdlog {
+namespace details {
+
+// digits of an unsigned int, rendered into a fixed buffer.
+struct int_text {
+    char data[24];
+    unsigned char size = 0;
+
+    void assign(size_t n) {
+        char *end = data + sizeof(data);
+        char *p = end;
+        do {
+            *--p = static_cast<char>('0' + n % 10);
+            n /= 10;
+        } while (n != 0);
+        size = static_cast<unsigned char>(end - p);
+        std::memmove(data, p, size);
+    }
+
+    string_view_t view() const { return string_view_t(data, size); }
+};
+
+#ifndef SPDLOG_NO_TLS
+// thread id text, cached per formatting thread. the table is direct mapped on the
+// id, so an async worker formatting for a handful of threads still mostly hits.
+inline string_view_t thread_id_text(size_t thread_id) {
+    static thread_local int_text cache[16];
+    static thread_local size_t cache_ids[16];
+    const size_t slot = thread_id % 16;
+    if (cache[slot].size == 0 || cache_ids[slot] != thread_id) {
+        cache[slot].assign(thread_id);
+        cache_ids[slot] = thread_id;
+    }
+    return cache[slot].view();
+}
+#endif
+
+// pid text, rendered once per process and again in the child after fork().
+class pid_text {
+public:
+    static string_view_t get() { return instance_().text_.view(); }
+
+private:
+    int_text text_;
+
+    pid_text() {
+        text_.assign(static_cast<uint32_t>(os::pid()));
+#ifndef _WIN32
+        ::pthread_atfork(nullptr, nullptr, [] {
+            instance_().text_.assign(static_cast<uint32_t>(os::pid()));
+        });
+#endif
+    }
+
+    static pid_text &instance_() {
+        static pid_text s_instance;
+        return s_instance;
+    }
+};
+
+}  // namespace details
+}  // namespace spdlog
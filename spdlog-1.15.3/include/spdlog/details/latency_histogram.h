@@ -0,0 +1,123 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+// Lock free log-linear (HDR style) histogram of nanosecond latencies.
+// Each power of two range is split into 8 linear sub buckets, so any recorded
+// value is reported with at most 12.5% error, using a fixed 4KB of counters.
+// record() is a couple of relaxed atomic adds and may be called concurrently
+// with readers.
+
+#include <spdlog/common.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+    #include <intrin.h>
+#endif
+
+namespace spdlog {
+namespace details {
+
+class latency_histogram {
+public:
+    static const unsigned sub_bucket_bits = 3;
+    static const unsigned sub_buckets = 1u << sub_bucket_bits;
+    static const size_t bucket_count = (64 - sub_bucket_bits + 1) * sub_buckets;
+
+    latency_histogram() { reset(); }
+    latency_histogram(const latency_histogram &) = delete;
+    latency_histogram &operator=(const latency_histogram &) = delete;
+
+    void record(uint64_t nanos) SPDLOG_NOEXCEPT {
+        counts_[bucket_index(nanos)].fetch_add(1, std::memory_order_relaxed);
+        total_.fetch_add(1, std::memory_order_relaxed);
+        auto prev_max = max_.load(std::memory_order_relaxed);
+        while (nanos > prev_max &&
+               !max_.compare_exchange_weak(prev_max, nanos, std::memory_order_relaxed)) {
+        }
+    }
+
+    uint64_t count() const SPDLOG_NOEXCEPT { return total_.load(std::memory_order_relaxed); }
+
+    uint64_t max() const SPDLOG_NOEXCEPT { return max_.load(std::memory_order_relaxed); }
+
+    // value (in nanos) below which the given fraction (0..1) of the samples fall.
+    // returns 0 if empty.
+    uint64_t percentile(double fraction) const SPDLOG_NOEXCEPT {
+        const auto total = count();
+        if (total == 0) {
+            return 0;
+        }
+        auto rank = static_cast<uint64_t>(fraction * static_cast<double>(total));
+        if (rank >= total) {
+            rank = total - 1;
+        }
+        uint64_t seen = 0;
+        for (size_t i = 0; i < bucket_count; i++) {
+            seen += counts_[i].load(std::memory_order_relaxed);
+            if (seen > rank) {
+                auto upper = bucket_upper_bound(i);
+                auto max_seen = max();
+                return upper < max_seen ? upper : max_seen;
+            }
+        }
+        return max();
+    }
+
+    void reset() SPDLOG_NOEXCEPT {
+        for (auto &c : counts_) {
+            c.store(0, std::memory_order_relaxed);
+        }
+        total_.store(0, std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+    }
+
+    static size_t bucket_index(uint64_t v) SPDLOG_NOEXCEPT {
+        if (v < sub_buckets) {
+            return static_cast<size_t>(v);
+        }
+        const unsigned msb = most_significant_bit(v);
+        const unsigned shift = msb - sub_bucket_bits;
+        return ((msb - sub_bucket_bits + 1) << sub_bucket_bits) +
+               static_cast<size_t>((v >> shift) & (sub_buckets - 1));
+    }
+
+    // highest value that maps to the given bucket
+    static uint64_t bucket_upper_bound(size_t index) SPDLOG_NOEXCEPT {
+        if (index < sub_buckets) {
+            return index;
+        }
+        const auto shift = static_cast<unsigned>(index >> sub_bucket_bits) - 1;
+        const uint64_t lower = static_cast<uint64_t>(sub_buckets + (index & (sub_buckets - 1)))
+                               << shift;
+        return lower + ((uint64_t{1} << shift) - 1);
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, bucket_count> counts_;
+    std::atomic<uint64_t> total_{0};
+    std::atomic<uint64_t> max_{0};
+
+    static unsigned most_significant_bit(uint64_t v) SPDLOG_NOEXCEPT {
+#if defined(__GNUC__) || defined(__clang__)
+        return 63u - static_cast<unsigned>(__builtin_clzll(v));
+#elif defined(_MSC_VER) && defined(_M_X64)
+        unsigned long index;
+        _BitScanReverse64(&index, v);
+        return static_cast<unsigned>(index);
+#else
+        unsigned msb = 0;
+        while (v >>= 1) {
+            msb++;
+        }
+        return msb;
+#endif
+    }
+};
+
+}  // namespace details
+}  // namespace spdlog
@@ -8,6 +8,9 @@
 #endif
 
 #include <spdlog/details/os.h>
+#ifdef SPDLOG_TSC_CLOCK
+    #include <spdlog/details/tsc_clock.h>
+#endif
 
 namespace spdlog {
 namespace details {
@@ -33,12 +36,20 @@ SPDLOG_INLINE log_msg::log_msg(spdlog::source_loc loc,
                                string_view_t a_logger_name,
                                spdlog::level::level_enum lvl,
                                spdlog::string_view_t msg)
-    : log_msg(os::now(), loc, a_logger_name, lvl, msg) {}
+#ifdef SPDLOG_TSC_CLOCK
+    : log_msg(log_clock::time_point{}, loc, a_logger_name, lvl, msg) {
+    ticks = tsc_clock::ticks();
+    time = tsc_clock::instance().to_time_point(ticks);
+}
+#else
+    : log_msg(os::now(), loc, a_logger_name, lvl, msg) {
+}
+#endif
 
 SPDLOG_INLINE log_msg::log_msg(string_view_t a_logger_name,
                                spdlog::level::level_enum lvl,
                                spdlog::string_view_t msg)
-    : log_msg(os::now(), source_loc{}, a_logger_name, lvl, msg) {}
+    : log_msg(source_loc{}, a_logger_name, lvl, msg) {}
 
 }  // namespace details
 }  // namespace spdlog
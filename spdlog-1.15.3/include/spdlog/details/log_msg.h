@@ -23,6 +23,8 @@ struct SPDLOG_API log_msg {
     string_view_t logger_name;
     level::level_enum level{level::off};
     log_clock::time_point time;
+    // raw tsc_clock ticks the time was derived from (SPDLOG_TSC_CLOCK), otherwise 0
+    uint64_t ticks{0};
     size_t thread_id{0};
 
     // wrapping the formatted text with color (updated by pattern_formatter).
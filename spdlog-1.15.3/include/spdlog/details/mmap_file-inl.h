@@ -0,0 +1,159 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#ifndef SPDLOG_HEADER_ONLY
+    #include <spdlog/details/mmap_file.h>
+#endif
+
+#include <spdlog/details/os.h>
+
+#include <cerrno>
+#include <string>
+
+#ifdef _WIN32
+    #include <spdlog/details/windows_include.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
+namespace spdlog {
+namespace details {
+
+SPDLOG_INLINE mmap_file::~mmap_file() { close(); }
+
+#ifdef _WIN32
+// extending a file through its mapping allocates it on NTFS, no separate preallocation
+SPDLOG_INLINE void mmap_file::open(const filename_t &fname, size_t size, bool) {
+    close();
+    filename_ = fname;
+    os::create_dir(os::dir_name(fname));
+    #ifdef SPDLOG_WCHAR_FILENAMES
+    HANDLE file = ::CreateFileW(fname.c_str(), GENERIC_READ | GENERIC_WRITE,
+                                FILE_SHARE_READ | FILE_SHARE_DELETE,
+                                nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    #else
+    HANDLE file = ::CreateFileA(fname.c_str(), GENERIC_READ | GENERIC_WRITE,
+                                FILE_SHARE_READ | FILE_SHARE_DELETE,
+                                nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    #endif
+    if (file == INVALID_HANDLE_VALUE) {
+        throw_spdlog_ex("Failed opening file " + os::filename_to_str(fname) + " for mapping",
+                        static_cast<int>(::GetLastError()));
+    }
+    const auto size64 = static_cast<unsigned long long>(size);
+    HANDLE mapping = ::CreateFileMappingW(file, nullptr, PAGE_READWRITE,
+                                          static_cast<DWORD>(size64 >> 32),
+                                          static_cast<DWORD>(size64 & 0xFFFFFFFFULL), nullptr);
+    void *view = mapping ? ::MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size) : nullptr;
+    if (view == nullptr) {
+        auto err = static_cast<int>(::GetLastError());
+        if (mapping) {
+            ::CloseHandle(mapping);
+        }
+        ::CloseHandle(file);
+        throw_spdlog_ex("Failed mapping file " + os::filename_to_str(fname), err);
+    }
+    file_handle_ = file;
+    mapping_handle_ = mapping;
+    data_ = static_cast<char *>(view);
+    size_ = size;
+}
+
+SPDLOG_INLINE void mmap_file::close() { close(size_); }
+
+SPDLOG_INLINE void mmap_file::close(size_t length) {
+    if (data_ != nullptr) {
+        ::UnmapViewOfFile(data_);
+        ::CloseHandle(static_cast<HANDLE>(mapping_handle_));
+        if (length < size_) {
+            LARGE_INTEGER end;
+            end.QuadPart = static_cast<LONGLONG>(length);
+            ::SetFilePointerEx(static_cast<HANDLE>(file_handle_), end, nullptr, FILE_BEGIN);
+            ::SetEndOfFile(static_cast<HANDLE>(file_handle_));
+        }
+        ::CloseHandle(static_cast<HANDLE>(file_handle_));
+        data_ = nullptr;
+        mapping_handle_ = nullptr;
+        file_handle_ = nullptr;
+        size_ = 0;
+    }
+}
+
+SPDLOG_INLINE void mmap_file::sync_async() {
+    if (data_ != nullptr) {
+        ::FlushViewOfFile(data_, 0);
+    }
+}
+#else
+SPDLOG_INLINE void mmap_file::open(const filename_t &fname, size_t size, bool preallocate) {
+    close();
+    filename_ = fname;
+    os::create_dir(os::dir_name(fname));
+    int fd = ::open(fname.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd == -1) {
+        throw_spdlog_ex("Failed opening file " + os::filename_to_str(fname) + " for mapping",
+                        errno);
+    }
+    if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        auto err = errno;
+        ::close(fd);
+        throw_spdlog_ex("Failed resizing file " + os::filename_to_str(fname), err);
+    }
+    #ifdef __linux__
+    // EOPNOTSUPP: the file system can't preallocate, the file stays sparse
+    int alloc_err = preallocate ? ::posix_fallocate(fd, 0, static_cast<off_t>(size)) : 0;
+    if (alloc_err != 0 && alloc_err != EOPNOTSUPP && alloc_err != EINVAL) {
+        ::close(fd);
+        throw_spdlog_ex("Failed preallocating file " + os::filename_to_str(fname), alloc_err);
+    }
+    #else
+    (void)preallocate;
+    #endif
+    void *addr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        auto err = errno;
+        ::close(fd);
+        throw_spdlog_ex("Failed mapping file " + os::filename_to_str(fname), err);
+    }
+    fd_ = fd;
+    data_ = static_cast<char *>(addr);
+    size_ = size;
+}
+
+SPDLOG_INLINE void mmap_file::close() { close(size_); }
+
+SPDLOG_INLINE void mmap_file::close(size_t length) {
+    if (data_ != nullptr) {
+        ::munmap(data_, size_);
+        if (length < size_) {
+            (void)::ftruncate(fd_, static_cast<off_t>(length));
+        }
+        ::close(fd_);
+        data_ = nullptr;
+        fd_ = -1;
+        size_ = 0;
+    }
+}
+
+SPDLOG_INLINE void mmap_file::sync_async() {
+    if (data_ != nullptr) {
+        ::msync(data_, size_, MS_ASYNC);
+    }
+}
+#endif
+
+SPDLOG_INLINE void mmap_file::rename(const filename_t &new_fname) {
+    if (os::rename(filename_, new_fname) != 0) {
+        throw_spdlog_ex("Failed renaming " + os::filename_to_str(filename_) + " to " +
+                            os::filename_to_str(new_fname),
+                        errno);
+    }
+    filename_ = new_fname;
+}
+
+}  // namespace details
+}  // namespace spdlog
@@ -0,0 +1,54 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <spdlog/common.h>
+
+namespace spdlog {
+namespace details {
+
+// Fixed size read/write memory mapping of a file.
+// Throw spdlog_ex exception on errors.
+
+class SPDLOG_API mmap_file {
+public:
+    mmap_file() = default;
+    mmap_file(const mmap_file &) = delete;
+    mmap_file &operator=(const mmap_file &) = delete;
+    ~mmap_file();
+
+    // create (or truncate) the file, extend it to the given size and map it.
+    // preallocate: reserve the disk blocks up front (fallocate), so a full disk is
+    // reported here rather than by a SIGBUS on first write to a page.
+    void open(const filename_t &fname, size_t size, bool preallocate = false);
+    void close();
+    // unmap and cut the file down to its first "length" bytes
+    void close(size_t length);
+    // schedule writeback of the mapped pages, without waiting for it
+    void sync_async();
+    // rename the underlying file, the mapping stays valid
+    void rename(const filename_t &new_fname);
+    bool is_open() const { return data_ != nullptr; }
+
+    char *data() { return data_; }
+    size_t size() const { return size_; }
+    const filename_t &filename() const { return filename_; }
+
+private:
+    char *data_{nullptr};
+    size_t size_{0};
+    filename_t filename_;
+#ifdef _WIN32
+    void *file_handle_{nullptr};
+    void *mapping_handle_{nullptr};
+#else
+    int fd_{-1};
+#endif
+};
+}  // namespace details
+}  // namespace spdlog
+
+#ifdef SPDLOG_HEADER_ONLY
+    #include "mmap_file-inl.h"
+#endif
@@ -9,84 +9,160 @@
 // the queue.
 // dequeue_for(..) - will block until the queue is not empty or timeout have
 // passed.
+//
+// Items can be pushed to a small separate priority lane which consumers always
+// drain first.
+//
+// Consumers may spin before parking (see async_wait_strategy), and producers /
+// consumers only notify the other side's condition variable when someone is
+// actually parked on it.
 
 #include <spdlog/details/circular_q.h>
 
 #include <atomic>
 #include <condition_variable>
 #include <mutex>
+#include <thread>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    #include <immintrin.h>
+#endif
 
 namespace spdlog {
 namespace details {
 
+// hint the cpu that we are in a spin-wait loop
+inline void spin_pause() SPDLOG_NOEXCEPT {
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
 template <typename T>
 class mpmc_blocking_queue {
 public:
     using item_type = T;
-    explicit mpmc_blocking_queue(size_t max_items)
-        : q_(max_items) {}
+    explicit mpmc_blocking_queue(size_t max_items, size_t max_priority_items = 0)
+        : q_(max_items) {
+        if (max_priority_items > 0) {
+            priority_q_ = circular_q<T>(max_priority_items);
+        }
+    }
 
 #ifndef __MINGW32__
     // try to enqueue and block if no room left
-    void enqueue(T &&item) {
+    void enqueue(T &&item, bool priority = false) {
+        bool wake_consumer;
         {
             std::unique_lock<std::mutex> lock(queue_mutex_);
-            pop_cv_.wait(lock, [this] { return !this->q_.full(); });
-            q_.push_back(std::move(item));
+            if (lane_(priority).full()) {
+                ++parked_producers_[priority];
+                pop_cv_[priority].wait(lock,
+                                       [this, priority] { return !this->lane_(priority).full(); });
+                --parked_producers_[priority];
+            }
+            push_(std::move(item), priority);
+            wake_consumer = parked_consumers_ > 0;
+        }
+        if (wake_consumer) {
+            push_cv_.notify_one();
         }
-        push_cv_.notify_one();
     }
 
     // enqueue immediately. overrun oldest message in the queue if no room left.
-    void enqueue_nowait(T &&item) {
+    void enqueue_nowait(T &&item, bool priority = false) {
+        bool wake_consumer;
         {
             std::unique_lock<std::mutex> lock(queue_mutex_);
-            q_.push_back(std::move(item));
+            push_(std::move(item), priority);
+            wake_consumer = parked_consumers_ > 0;
+        }
+        if (wake_consumer) {
+            push_cv_.notify_one();
         }
-        push_cv_.notify_one();
     }
 
-    void enqueue_if_have_room(T &&item) {
+    void enqueue_if_have_room(T &&item, bool priority = false) {
         bool pushed = false;
+        bool wake_consumer = false;
         {
             std::unique_lock<std::mutex> lock(queue_mutex_);
-            if (!q_.full()) {
-                q_.push_back(std::move(item));
+            if (!lane_(priority).full()) {
+                push_(std::move(item), priority);
                 pushed = true;
+                wake_consumer = parked_consumers_ > 0;
             }
         }
 
-        if (pushed) {
+        if (!pushed) {
+            ++(priority ? priority_discard_counter_ : discard_counter_);
+        } else if (wake_consumer) {
             push_cv_.notify_one();
-        } else {
-            ++discard_counter_;
         }
     }
 
+    // enqueue if there is room. leave the item untouched and return false otherwise.
+    bool try_enqueue(T &&item, bool priority = false) {
+        bool wake_consumer;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex_);
+            if (lane_(priority).full()) {
+                return false;
+            }
+            push_(std::move(item), priority);
+            wake_consumer = parked_consumers_ > 0;
+        }
+        if (wake_consumer) {
+            push_cv_.notify_one();
+        }
+        return true;
+    }
+
     // dequeue with a timeout.
     // Return true, if succeeded dequeue item, false otherwise
     bool dequeue_for(T &popped_item, std::chrono::milliseconds wait_duration) {
+        bool wake_producer;
+        bool from_priority;
         {
             std::unique_lock<std::mutex> lock(queue_mutex_);
-            if (!push_cv_.wait_for(lock, wait_duration, [this] { return !this->q_.empty(); })) {
-                return false;
+            if (empty_()) {
+                ++parked_consumers_;
+                bool ready =
+                    push_cv_.wait_for(lock, wait_duration, [this] { return !this->empty_(); });
+                --parked_consumers_;
+                if (!ready) {
+                    return false;
+                }
             }
-            popped_item = std::move(q_.front());
-            q_.pop_front();
+            from_priority = pop_(popped_item);
+            wake_producer = parked_producers_[from_priority] > 0;
+        }
+        if (wake_producer) {
+            pop_cv_[from_priority].notify_one();
         }
-        pop_cv_.notify_one();
         return true;
     }
 
     // blocking dequeue without a timeout.
     void dequeue(T &popped_item) {
+        bool wake_producer;
+        bool from_priority;
         {
-            std::unique_lock<std::mutex> lock(queue_mutex_);
-            push_cv_.wait(lock, [this] { return !this->q_.empty(); });
-            popped_item = std::move(q_.front());
-            q_.pop_front();
+            std::unique_lock<std::mutex> lock(queue_mutex_, std::defer_lock);
+            lock_when_not_empty_(lock);
+            if (empty_()) {
+                ++parked_consumers_;
+                push_cv_.wait(lock, [this] { return !this->empty_(); });
+                --parked_consumers_;
+            }
+            from_priority = pop_(popped_item);
+            wake_producer = parked_producers_[from_priority] > 0;
+        }
+        if (wake_producer) {
+            pop_cv_[from_priority].notify_one();
         }
-        pop_cv_.notify_one();
     }
 
 #else
@@ -94,84 +170,241 @@ public:
     // so release the mutex at the very end each function.
 
     // try to enqueue and block if no room left
-    void enqueue(T &&item) {
+    void enqueue(T &&item, bool priority = false) {
         std::unique_lock<std::mutex> lock(queue_mutex_);
-        pop_cv_.wait(lock, [this] { return !this->q_.full(); });
-        q_.push_back(std::move(item));
-        push_cv_.notify_one();
+        if (lane_(priority).full()) {
+            ++parked_producers_[priority];
+            pop_cv_[priority].wait(lock, [this, priority] { return !this->lane_(priority).full(); });
+            --parked_producers_[priority];
+        }
+        push_(std::move(item), priority);
+        if (parked_consumers_ > 0) {
+            push_cv_.notify_one();
+        }
     }
 
     // enqueue immediately. overrun oldest message in the queue if no room left.
-    void enqueue_nowait(T &&item) {
+    void enqueue_nowait(T &&item, bool priority = false) {
         std::unique_lock<std::mutex> lock(queue_mutex_);
-        q_.push_back(std::move(item));
-        push_cv_.notify_one();
+        push_(std::move(item), priority);
+        if (parked_consumers_ > 0) {
+            push_cv_.notify_one();
+        }
     }
 
-    void enqueue_if_have_room(T &&item) {
-        bool pushed = false;
+    void enqueue_if_have_room(T &&item, bool priority = false) {
         std::unique_lock<std::mutex> lock(queue_mutex_);
-        if (!q_.full()) {
-            q_.push_back(std::move(item));
-            pushed = true;
+        if (lane_(priority).full()) {
+            ++(priority ? priority_discard_counter_ : discard_counter_);
+            return;
+        }
+        push_(std::move(item), priority);
+        if (parked_consumers_ > 0) {
+            push_cv_.notify_one();
         }
+    }
 
-        if (pushed) {
+    // enqueue if there is room. leave the item untouched and return false otherwise.
+    bool try_enqueue(T &&item, bool priority = false) {
+        std::unique_lock<std::mutex> lock(queue_mutex_);
+        if (lane_(priority).full()) {
+            return false;
+        }
+        push_(std::move(item), priority);
+        if (parked_consumers_ > 0) {
             push_cv_.notify_one();
-        } else {
-            ++discard_counter_;
         }
+        return true;
     }
 
     // dequeue with a timeout.
     // Return true, if succeeded dequeue item, false otherwise
     bool dequeue_for(T &popped_item, std::chrono::milliseconds wait_duration) {
         std::unique_lock<std::mutex> lock(queue_mutex_);
-        if (!push_cv_.wait_for(lock, wait_duration, [this] { return !this->q_.empty(); })) {
-            return false;
+        if (empty_()) {
+            ++parked_consumers_;
+            bool ready =
+                push_cv_.wait_for(lock, wait_duration, [this] { return !this->empty_(); });
+            --parked_consumers_;
+            if (!ready) {
+                return false;
+            }
+        }
+        bool from_priority = pop_(popped_item);
+        if (parked_producers_[from_priority] > 0) {
+            pop_cv_[from_priority].notify_one();
         }
-        popped_item = std::move(q_.front());
-        q_.pop_front();
-        pop_cv_.notify_one();
         return true;
     }
 
     // blocking dequeue without a timeout.
     void dequeue(T &popped_item) {
-        std::unique_lock<std::mutex> lock(queue_mutex_);
-        push_cv_.wait(lock, [this] { return !this->q_.empty(); });
-        popped_item = std::move(q_.front());
-        q_.pop_front();
-        pop_cv_.notify_one();
+        std::unique_lock<std::mutex> lock(queue_mutex_, std::defer_lock);
+        lock_when_not_empty_(lock);
+        if (empty_()) {
+            ++parked_consumers_;
+            push_cv_.wait(lock, [this] { return !this->empty_(); });
+            --parked_consumers_;
+        }
+        bool from_priority = pop_(popped_item);
+        if (parked_producers_[from_priority] > 0) {
+            pop_cv_[from_priority].notify_one();
+        }
     }
 
 #endif
 
-    size_t overrun_counter() {
+    size_t overrun_counter(bool priority = false) {
         std::lock_guard<std::mutex> lock(queue_mutex_);
-        return q_.overrun_counter();
+        return lane_(priority).overrun_counter();
     }
 
-    size_t discard_counter() { return discard_counter_.load(std::memory_order_relaxed); }
+    size_t discard_counter(bool priority = false) {
+        return (priority ? priority_discard_counter_ : discard_counter_)
+            .load(std::memory_order_relaxed);
+    }
 
+    // number of items in both lanes
     size_t size() {
         std::lock_guard<std::mutex> lock(queue_mutex_);
-        return q_.size();
+        return q_.size() + priority_q_.size();
+    }
+
+    void reset_overrun_counter(bool priority = false) {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        lane_(priority).reset_overrun_counter();
+    }
+
+    void reset_discard_counter(bool priority = false) {
+        (priority ? priority_discard_counter_ : discard_counter_)
+            .store(0, std::memory_order_relaxed);
+    }
+
+    // max number of items (both lanes) seen in the queue
+    size_t high_water_mark() {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        return high_water_mark_;
     }
 
-    void reset_overrun_counter() {
+    void reset_high_water_mark() {
         std::lock_guard<std::mutex> lock(queue_mutex_);
-        q_.reset_overrun_counter();
+        high_water_mark_ = q_.size() + priority_q_.size();
     }
 
-    void reset_discard_counter() { discard_counter_.store(0, std::memory_order_relaxed); }
+    bool has_priority_lane() const { return priority_q_.capacity() > 0; }
+
+    // number of items pushed to a lane so far, and how many of them left it (popped or
+    // overrun). items leave a lane in push order.
+    uint64_t pushed_count(bool priority = false) {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        return pushed_[priority];
+    }
+
+    uint64_t removed_count(bool priority = false) {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        return pushed_[priority] - lane_(priority).size();
+    }
+
+    // true if both lanes are empty and at least n consumers wait in dequeue() (spinning or
+    // parked), so they don't hold any item.
+    bool idle(size_t n) {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        // acquire: what a spinning consumer did before it started spinning happened before
+        return empty_() &&
+               parked_consumers_ + spinning_consumers_.load(std::memory_order_acquire) >= n;
+    }
+
+    // how dequeue() waits on an empty queue (dequeue_for() always parks). spin_budget is the
+    // number of spin iterations before spin_yield / spin_park give up spinning.
+    void set_wait_strategy(async_wait_strategy strategy, size_t spin_budget) {
+        wait_strategy_.store(strategy, std::memory_order_relaxed);
+        spin_budget_.store(spin_budget, std::memory_order_relaxed);
+    }
 
 private:
     std::mutex queue_mutex_;
     std::condition_variable push_cv_;
-    std::condition_variable pop_cv_;
+    std::condition_variable pop_cv_[2];  // indexed by lane (1 = priority)
     spdlog::details::circular_q<T> q_;
+    spdlog::details::circular_q<T> priority_q_;
     std::atomic<size_t> discard_counter_{0};
+    std::atomic<size_t> priority_discard_counter_{0};
+
+    // number of threads waiting on push_cv_ / pop_cv_ (guarded by queue_mutex_)
+    size_t parked_consumers_ = 0;
+    size_t parked_producers_[2] = {0, 0};
+    size_t high_water_mark_ = 0;
+    uint64_t pushed_[2] = {0, 0};
+
+    // q_.size() mirror so spinning consumers can poll without taking the mutex
+    std::atomic<size_t> approx_size_{0};
+    std::atomic<async_wait_strategy> wait_strategy_{async_wait_strategy::block};
+    std::atomic<size_t> spin_budget_{0};
+    std::atomic<size_t> spinning_consumers_{0};
+
+    circular_q<T> &lane_(bool priority) { return priority ? priority_q_ : q_; }
+
+    bool empty_() const { return q_.empty() && priority_q_.empty(); }
+
+    void push_(T &&item, bool priority) {
+        lane_(priority).push_back(std::move(item));
+        pushed_[priority]++;
+        const auto new_size = q_.size() + priority_q_.size();
+        if (new_size > high_water_mark_) {
+            high_water_mark_ = new_size;
+        }
+        approx_size_.store(new_size, std::memory_order_release);
+    }
+
+    // the priority lane is always drained first. return true if popped from it.
+    bool pop_(T &popped_item) {
+        const bool from_priority = !priority_q_.empty();
+        auto &lane = lane_(from_priority);
+        popped_item = std::move(lane.front());
+        lane.pop_front();
+        approx_size_.store(q_.size() + priority_q_.size(), std::memory_order_release);
+        return from_priority;
+    }
+
+    // spin per the wait strategy and lock. if another consumer took the item meanwhile, the
+    // strategies which never park spin again; the others return with the queue empty.
+    void lock_when_not_empty_(std::unique_lock<std::mutex> &lock) {
+        for (;;) {
+            spin_while_empty_();
+            lock.lock();
+            const auto strategy = wait_strategy_.load(std::memory_order_relaxed);
+            if (!empty_() || (strategy != async_wait_strategy::busy_spin &&
+                              strategy != async_wait_strategy::spin_yield)) {
+                return;
+            }
+            lock.unlock();
+        }
+    }
+
+    void spin_while_empty_() {
+        const auto strategy = wait_strategy_.load(std::memory_order_relaxed);
+        if (strategy == async_wait_strategy::block) {
+            return;
+        }
+        spinning_consumers_.fetch_add(1, std::memory_order_release);
+        spin_(strategy);
+        spinning_consumers_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void spin_(async_wait_strategy strategy) {
+        const auto budget = spin_budget_.load(std::memory_order_relaxed);
+        for (size_t i = 0; strategy == async_wait_strategy::busy_spin || i < budget; i++) {
+            if (approx_size_.load(std::memory_order_acquire) != 0) {
+                return;
+            }
+            spin_pause();
+        }
+        if (strategy == async_wait_strategy::spin_yield) {
+            while (approx_size_.load(std::memory_order_acquire) == 0) {
+                std::this_thread::yield();
+            }
+        }
+    }
 };
 }  // namespace details
 }  // namespace spdlog
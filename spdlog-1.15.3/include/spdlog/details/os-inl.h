@@ -11,6 +11,7 @@
 
 #include <algorithm>
 #include <array>
+#include <cerrno>
 #include <chrono>
 #include <cstdio>
 #include <cstdlib>
@@ -41,6 +42,7 @@
 #else  // unix
 
     #include <fcntl.h>
+    #include <sys/uio.h>  // for writev
     #include <unistd.h>
 
     #ifdef __linux__
@@ -589,6 +591,37 @@ SPDLOG_INLINE bool fsync(FILE *fp) {
 #endif
 }
 
+SPDLOG_INLINE bool fdatasync(FILE *fp) {
+#ifdef _WIN32
+    return FlushFileBuffers(reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(fp)))) != 0;
+#elif defined(__APPLE__)
+    return ::fsync(fileno(fp)) == 0;
+#else
+    return ::fdatasync(fileno(fp)) == 0;
+#endif
+}
+
+SPDLOG_INLINE bool preallocate(FILE *fp, size_t offset, size_t len) {
+#ifdef __linux__
+    return ::fallocate(fileno(fp), FALLOC_FL_KEEP_SIZE, static_cast<off_t>(offset),
+                       static_cast<off_t>(len)) == 0;
+#else
+    (void)fp;
+    (void)offset;
+    (void)len;
+    return false;
+#endif
+}
+
+SPDLOG_INLINE void release_preallocated(FILE *fp) {
+#ifdef __linux__
+    // truncating to the current size frees the blocks past it
+    (void)::ftruncate(fileno(fp), static_cast<off_t>(filesize(fp)));
+#else
+    (void)fp;
+#endif
+}
+
 // Do non-locking fwrite if possible by the os or use the regular locking fwrite
 // Return true on success.
 SPDLOG_INLINE bool fwrite_bytes(const void *ptr, const size_t n_bytes, FILE *fp) {
@@ -601,6 +634,58 @@ SPDLOG_INLINE bool fwrite_bytes(const void *ptr, const size_t n_bytes, FILE *fp)
 #endif
 }
 
+SPDLOG_INLINE bool write_direct(
+    FILE *fp, const void *ptr1, size_t n_bytes1, const void *ptr2, size_t n_bytes2) {
+#ifdef _WIN32
+    const int fd = _fileno(fp);
+    const void *ptrs[2] = {ptr1, ptr2};
+    size_t sizes[2] = {n_bytes1, n_bytes2};
+    for (int i = 0; i < 2; i++) {
+        auto *p = static_cast<const char *>(ptrs[i]);
+        while (sizes[i] > 0) {
+            const auto chunk = static_cast<unsigned int>((std::min)(sizes[i], size_t{1} << 30));
+            const int written = ::_write(fd, p, chunk);
+            if (written < 0) {
+                return false;
+            }
+            p += written;
+            sizes[i] -= static_cast<size_t>(written);
+        }
+    }
+    return true;
+#else
+    const int fd = fileno(fp);
+    struct iovec iov[2];
+    iov[0].iov_base = const_cast<void *>(ptr1);
+    iov[0].iov_len = n_bytes1;
+    iov[1].iov_base = const_cast<void *>(ptr2);
+    iov[1].iov_len = n_bytes2;
+    struct iovec *pending = iov;
+    int count = n_bytes2 > 0 ? 2 : 1;
+    while (count > 0) {
+        const ssize_t written = ::writev(fd, pending, count);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        // skip what was written, partial writes included
+        auto left = static_cast<size_t>(written);
+        while (count > 0 && left >= pending->iov_len) {
+            left -= pending->iov_len;
+            pending++;
+            count--;
+        }
+        if (count > 0) {
+            pending->iov_base = static_cast<char *>(pending->iov_base) + left;
+            pending->iov_len -= left;
+        }
+    }
+    return true;
+#endif
+}
+
 }  // namespace os
 }  // namespace details
 }  // namespace spdlog
@@ -114,10 +114,29 @@ SPDLOG_API std::string getenv(const char *field);
 // Return true on success.
 SPDLOG_API bool fsync(FILE *fp);
 
+// Like fsync(), but skips the metadata not needed to read the data back (fdatasync).
+// Return true on success.
+SPDLOG_API bool fdatasync(FILE *fp);
+
+// Reserve disk blocks for [offset, offset + len) without changing the file size
+// (fallocate with FALLOC_FL_KEEP_SIZE). Linux only, return false elsewhere.
+SPDLOG_API bool preallocate(FILE *fp, size_t offset, size_t len);
+
+// Give back the blocks reserved past the end of the file by preallocate().
+SPDLOG_API void release_preallocated(FILE *fp);
+
 // Do non-locking fwrite if possible by the os or use the regular locking fwrite
 // Return true on success.
 SPDLOG_API bool fwrite_bytes(const void *ptr, const size_t n_bytes, FILE *fp);
 
+// Write the two ranges to the file descriptor of fp, bypassing its stdio buffer
+// (writev() where available). Return true on success.
+SPDLOG_API bool write_direct(FILE *fp,
+                             const void *ptr1,
+                             size_t n_bytes1,
+                             const void *ptr2 = nullptr,
+                             size_t n_bytes2 = 0);
+
 }  // namespace os
 }  // namespace details
 }  // namespace spdlog
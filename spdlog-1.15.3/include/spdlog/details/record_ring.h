@@ -0,0 +1,113 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <spdlog/common.h>
+
+#include <cstring>
+#include <vector>
+
+namespace spdlog {
+namespace details {
+
+// Ring of variable size records in a single buffer allocated once.
+// A record is always contiguous: one that doesn't fit at the end of the buffer goes at its
+// beginning. Adding a record removes the oldest ones until there is room for it.
+// Not thread safe.
+class record_ring {
+public:
+    // bytes taken by each record on top of its own size
+    static constexpr size_t header_size = sizeof(size_t);
+
+    record_ring() = default;
+    explicit record_ring(size_t capacity)
+        : buffer_(capacity) {}
+
+    // room for a new record of the given size, to be filled by the caller.
+    // nullptr if the record can't fit in the buffer.
+    char *push_back(size_t size) {
+        const size_t needed = header_size + size;
+        if (needed > buffer_.size()) {
+            return nullptr;
+        }
+        for (;;) {
+            if (count_ == 0) {
+                head_ = tail_ = end_ = 0;
+                wrapped_ = false;
+            }
+            if (!wrapped_) {
+                if (buffer_.size() - tail_ >= needed) {
+                    break;
+                }
+                // go on at the beginning, before the oldest record
+                end_ = tail_;
+                tail_ = 0;
+                wrapped_ = true;
+            }
+            if (head_ - tail_ >= needed) {
+                break;
+            }
+            pop_front();
+        }
+        std::memcpy(&buffer_[tail_], &size, header_size);
+        char *record = &buffer_[tail_ + header_size];
+        tail_ += needed;
+        count_++;
+        return record;
+    }
+
+    void pop_front() {
+        head_ += header_size + record_size_(head_);
+        count_--;
+        if (wrapped_ && head_ == end_) {
+            head_ = 0;
+            wrapped_ = false;
+        }
+    }
+
+    // call func(string_view_t record) for each record, oldest first, skipping the first skip ones
+    template <typename Func>
+    void for_each(Func &&func, size_t skip = 0) const {
+        size_t pos = head_;
+        bool wrapped = wrapped_;
+        for (size_t i = 0; i < count_; i++) {
+            if (wrapped && pos == end_) {
+                pos = 0;
+                wrapped = false;
+            }
+            const size_t size = record_size_(pos);
+            if (i >= skip) {
+                func(string_view_t(&buffer_[pos + header_size], size));
+            }
+            pos += header_size + size;
+        }
+    }
+
+    void clear() { count_ = 0; }
+
+    size_t size() const { return count_; }
+
+    bool empty() const { return count_ == 0; }
+
+    // bytes of the buffer
+    size_t capacity() const { return buffer_.size(); }
+
+private:
+    std::vector<char> buffer_;
+    // records are in [head_, tail_), or in [head_, end_) then [0, tail_) when wrapped_
+    size_t head_ = 0;
+    size_t tail_ = 0;
+    size_t end_ = 0;
+    size_t count_ = 0;
+    bool wrapped_ = false;
+
+    size_t record_size_(size_t pos) const {
+        size_t size;
+        std::memcpy(&size, &buffer_[pos], header_size);
+        return size;
+    }
+};
+
+}  // namespace details
+}  // namespace spdlog
@@ -7,26 +7,128 @@
     #include <spdlog/details/thread_pool.h>
 #endif
 
-#include <cassert>
+#include <spdlog/async_logger.h>
 #include <spdlog/common.h>
 
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
 namespace spdlog {
 namespace details {
 
+SPDLOG_INLINE memory_buf_t *async_arena::acquire() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!free_blocks_.empty()) {
+            auto *block = free_blocks_.back().release();
+            free_blocks_.pop_back();
+            return block;
+        }
+    }
+    return new memory_buf_t();
+}
+
+SPDLOG_INLINE void async_arena::release(memory_buf_t *block) {
+    std::unique_ptr<memory_buf_t> owned(block);
+    owned->clear();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (free_blocks_.size() < max_free_blocks) {
+        free_blocks_.push_back(std::move(owned));
+    }
+}
+
+SPDLOG_INLINE async_msg::async_msg(size_t slot,
+                                   async_msg_type the_type,
+                                   const details::log_msg &m,
+                                   async_arena &arena)
+    : log_msg{m},
+      msg_type{the_type},
+      logger_slot{slot} {
+    const size_t needed = logger_name.size() + payload.size();
+    if (needed <= sizeof(inline_buf_)) {
+        std::memcpy(inline_buf_, logger_name.data(), logger_name.size());
+        std::memcpy(inline_buf_ + logger_name.size(), payload.data(), payload.size());
+        update_string_views_(inline_buf_);
+    } else {
+        arena_ = &arena;
+        block_ = arena.acquire();
+        block_->append(logger_name.data(), logger_name.data() + logger_name.size());
+        block_->append(payload.data(), payload.data() + payload.size());
+        update_string_views_(block_->data());
+    }
+}
+
+SPDLOG_INLINE async_msg::~async_msg() { release_block_(); }
+
+SPDLOG_INLINE async_msg::async_msg(async_msg &&other) SPDLOG_NOEXCEPT
+    : log_msg{other},
+      msg_type{other.msg_type},
+      logger_slot{other.logger_slot},
+      enqueue_time{other.enqueue_time} {
+    take_storage_(other);
+}
+
+SPDLOG_INLINE async_msg &async_msg::operator=(async_msg &&other) SPDLOG_NOEXCEPT {
+    if (this != &other) {
+        release_block_();
+        log_msg::operator=(other);
+        msg_type = other.msg_type;
+        logger_slot = other.logger_slot;
+        enqueue_time = other.enqueue_time;
+        take_storage_(other);
+    }
+    return *this;
+}
+
+// steal other's arena block, or copy only the used part of its inline buffer
+SPDLOG_INLINE void async_msg::take_storage_(async_msg &other) SPDLOG_NOEXCEPT {
+    if (other.block_ != nullptr) {
+        arena_ = other.arena_;
+        block_ = other.block_;
+        other.arena_ = nullptr;
+        other.block_ = nullptr;
+        update_string_views_(block_->data());
+    } else {
+        std::memcpy(inline_buf_, other.inline_buf_, logger_name.size() + payload.size());
+        update_string_views_(inline_buf_);
+    }
+}
+
+SPDLOG_INLINE void async_msg::release_block_() SPDLOG_NOEXCEPT {
+    if (block_ != nullptr) {
+        SPDLOG_TRY { arena_->release(block_); }
+        SPDLOG_CATCH_STD
+        arena_ = nullptr;
+        block_ = nullptr;
+    }
+}
+
+SPDLOG_INLINE void async_msg::update_string_views_(const char *data) SPDLOG_NOEXCEPT {
+    logger_name = string_view_t{data, logger_name.size()};
+    payload = string_view_t{data + logger_name.size(), payload.size()};
+}
+
 SPDLOG_INLINE thread_pool::thread_pool(size_t q_max_items,
                                        size_t threads_n,
                                        std::function<void()> on_thread_start,
                                        std::function<void()> on_thread_stop)
-    : q_(q_max_items) {
+    : q_(q_max_items, SPDLOG_ASYNC_PRIORITY_Q_SIZE) {
     if (threads_n == 0 || threads_n > 1000) {
         throw_spdlog_ex(
             "spdlog::thread_pool(): invalid threads_n param (valid "
             "range is 1-1000)");
     }
+    workers_.reset(new worker_state[threads_n]);
+    for (size_t i = 0; i < threads_n; i++) {
+        workers_[i].dispatching.store(async_msg::no_logger, std::memory_order_relaxed);
+        workers_[i].progress.store(0, std::memory_order_relaxed);
+    }
+    add_slot_chunk_();
     for (size_t i = 0; i < threads_n; i++) {
-        threads_.emplace_back([this, on_thread_start, on_thread_stop] {
+        threads_.emplace_back([this, i, on_thread_start, on_thread_stop] {
             on_thread_start();
-            this->thread_pool::worker_loop_();
+            this->thread_pool::worker_loop_(i);
             on_thread_stop();
         });
     }
@@ -54,16 +156,178 @@ SPDLOG_INLINE thread_pool::~thread_pool() {
     SPDLOG_CATCH_STD
 }
 
-void SPDLOG_INLINE thread_pool::post_log(async_logger_ptr &&worker_ptr,
+void SPDLOG_INLINE thread_pool::post_log(size_t logger_slot,
                                          const details::log_msg &msg,
                                          async_overflow_policy overflow_policy) {
-    async_msg async_m(std::move(worker_ptr), async_msg_type::log, msg);
-    post_async_msg_(std::move(async_m), overflow_policy);
+    async_msg async_m(logger_slot, async_msg_type::log, msg, arena_);
+    async_m.enqueue_time = std::chrono::steady_clock::now();
+    const bool priority = q_.has_priority_lane() &&
+                          msg.level >= priority_level_.load(std::memory_order_relaxed) &&
+                          msg.level != level::off;
+    post_async_msg_(std::move(async_m), overflow_policy, priority);
 }
 
-void SPDLOG_INLINE thread_pool::post_flush(async_logger_ptr &&worker_ptr,
+void SPDLOG_INLINE thread_pool::post_flush(size_t logger_slot,
                                            async_overflow_policy overflow_policy) {
-    post_async_msg_(async_msg(std::move(worker_ptr), async_msg_type::flush), overflow_policy);
+    post_async_msg_(async_msg(logger_slot, async_msg_type::flush), overflow_policy);
+}
+
+size_t SPDLOG_INLINE thread_pool::register_logger(async_logger *logger) {
+    std::lock_guard<std::mutex> lock(logger_slots_mutex_);
+    if (free_logger_slots_.empty()) {
+        add_slot_chunk_();
+    }
+    auto slot = free_logger_slots_.back();
+    free_logger_slots_.pop_back();
+    slot_ref_(slot).store(logger, std::memory_order_release);
+    return slot;
+}
+
+void SPDLOG_INLINE thread_pool::release_logger(size_t logger_slot) {
+    auto *logger = logger_at_(logger_slot);
+    if (logger == nullptr) {
+        return;
+    }
+    // nothing of the logger can be pending, no worker can be writing to it
+    if (pool_idle_(0)) {
+        slot_ref_(logger_slot).store(nullptr, std::memory_order_release);
+        free_slot_(logger_slot);
+        return;
+    }
+
+    retired_logger retired;
+    retired.slot = logger_slot;
+    retired.backend.reset(new async_logger(*logger, async_logger::backend_tag{}));
+    // seq_cst: pairs with the dispatching store of the workers (see dispatch_log_())
+    slot_ref_(logger_slot).store(retired.backend.get());
+    // a worker that read the old pointer is dispatching to the slot since before the store.
+    // wait until it is done with that msg (the next one goes to the copy).
+    const size_t self = worker_index_();
+    for (size_t i = 0; i < threads_.size(); i++) {
+        if (i == self) {
+            continue;
+        }
+        const auto progress = workers_[i].progress.load();
+        while (workers_[i].dispatching.load() == logger_slot &&
+               workers_[i].progress.load() == progress) {
+            std::this_thread::yield();
+        }
+    }
+
+    retired.pushed[0] = q_.pushed_count(false);
+    retired.pushed[1] = q_.pushed_count(true);
+    auto *spill = spill_.load(std::memory_order_acquire);
+    retired.spilled = spill != nullptr ? spill->appended() : 0;
+    std::lock_guard<std::mutex> lock(retired_mutex_);
+    retired_.push_back(std::move(retired));
+    retired_count_.store(retired_.size(), std::memory_order_release);
+}
+
+// Called by each worker before taking the next msg, so it holds none.
+// A retired logger is done with once the msgs pushed (or spilled) before its release were all
+// dequeued (or replayed) and each worker that may have dequeued one of them finished it: the
+// other workers are all idle, or each of them made progress since the msgs were all dequeued.
+void SPDLOG_INLINE thread_pool::reclaim_loggers_(size_t worker) {
+    if (retired_count_.load(std::memory_order_acquire) == 0) {
+        return;
+    }
+    std::vector<std::unique_ptr<async_logger>> done;
+    {
+        std::unique_lock<std::mutex> lock(retired_mutex_, std::try_to_lock);
+        if (!lock.owns_lock()) {
+            return;  // another worker is at it
+        }
+        const bool idle = pool_idle_(1);
+        const uint64_t removed[2] = {q_.removed_count(false), q_.removed_count(true)};
+        auto *spill = spill_.load(std::memory_order_acquire);
+        const uint64_t consumed = spill != nullptr ? spill->consumed() : 0;
+
+        for (size_t r = 0; r < retired_.size();) {
+            auto &retired = retired_[r];
+            bool finished = removed[0] >= retired.pushed[0] && removed[1] >= retired.pushed[1] &&
+                            (spill == nullptr || consumed >= retired.spilled);
+            if (finished && !idle) {
+                if (!retired.drained) {
+                    retired.drained = true;
+                    retired.progress.resize(threads_.size());
+                    for (size_t i = 0; i < threads_.size(); i++) {
+                        retired.progress[i] = workers_[i].progress.load(std::memory_order_acquire);
+                    }
+                    finished = false;
+                } else {
+                    for (size_t i = 0; i < threads_.size() && finished; i++) {
+                        const auto progress = workers_[i].progress.load(std::memory_order_acquire);
+                        finished = i == worker || progress != retired.progress[i];
+                    }
+                }
+            }
+            if (!finished) {
+                r++;
+                continue;
+            }
+            slot_ref_(retired.slot).store(nullptr, std::memory_order_release);
+            free_slot_(retired.slot);
+            done.push_back(std::move(retired.backend));
+            retired_.erase(retired_.begin() + static_cast<std::ptrdiff_t>(r));
+        }
+        retired_count_.store(retired_.size(), std::memory_order_release);
+    }
+    // the copies are destroyed out of the lock: closing their sinks may take a while
+}
+
+bool SPDLOG_INLINE thread_pool::pool_idle_(size_t busy_workers) {
+    auto *spill = spill_.load(std::memory_order_acquire);
+    if (spill != nullptr && spill->active()) {
+        return false;
+    }
+    return q_.idle(threads_.size() - busy_workers);
+}
+
+size_t SPDLOG_INLINE thread_pool::worker_index_() const {
+    const auto id = std::this_thread::get_id();
+    size_t i = 0;
+    while (i < threads_.size() && threads_[i].get_id() != id) {
+        i++;
+    }
+    return i;
+}
+
+SPDLOG_INLINE std::atomic<async_logger *> &thread_pool::slot_ref_(size_t logger_slot) const {
+    const auto *directory = slot_directory_.load(std::memory_order_acquire);
+    return (*directory)[logger_slot / slots_per_chunk]->loggers[logger_slot % slots_per_chunk];
+}
+
+SPDLOG_INLINE async_logger *thread_pool::logger_at_(size_t logger_slot) const {
+    const auto *directory = slot_directory_.load(std::memory_order_acquire);
+    if (logger_slot / slots_per_chunk >= directory->size()) {
+        return nullptr;
+    }
+    // seq_cst: pairs with the dispatching store (see release_logger())
+    return slot_ref_(logger_slot).load();
+}
+
+// called with logger_slots_mutex_ held, or from the constructor
+void SPDLOG_INLINE thread_pool::add_slot_chunk_() {
+    std::unique_ptr<slot_chunk> chunk(new slot_chunk());
+    for (auto &logger : chunk->loggers) {
+        logger.store(nullptr, std::memory_order_relaxed);
+    }
+    const auto *current = slot_directory_.load(std::memory_order_relaxed);
+    std::unique_ptr<slot_directory> directory(current != nullptr ? new slot_directory(*current)
+                                                                 : new slot_directory());
+    directory->push_back(chunk.get());
+    const size_t first = slot_chunks_.size() * slots_per_chunk;
+    slot_chunks_.push_back(std::move(chunk));
+    slot_directory_.store(directory.get(), std::memory_order_release);
+    slot_directories_.push_back(std::move(directory));
+    for (size_t i = slots_per_chunk; i > 0; i--) {
+        free_logger_slots_.push_back(first + i - 1);
+    }
+}
+
+void SPDLOG_INLINE thread_pool::free_slot_(size_t logger_slot) {
+    std::lock_guard<std::mutex> lock(logger_slots_mutex_);
+    free_logger_slots_.push_back(logger_slot);
 }
 
 size_t SPDLOG_INLINE thread_pool::overrun_counter() { return q_.overrun_counter(); }
@@ -76,41 +340,118 @@ void SPDLOG_INLINE thread_pool::reset_discard_counter() { q_.reset_discard_count
 
 size_t SPDLOG_INLINE thread_pool::queue_size() { return q_.size(); }
 
+size_t SPDLOG_INLINE thread_pool::queue_high_water_mark() { return q_.high_water_mark(); }
+
+void SPDLOG_INLINE thread_pool::reset_queue_high_water_mark() { q_.reset_high_water_mark(); }
+
+thread_pool_stats SPDLOG_INLINE thread_pool::stats() {
+    thread_pool_stats result;
+    result.queue_size = q_.size();
+    result.queue_high_water_mark = q_.high_water_mark();
+    result.overrun_counter = q_.overrun_counter();
+    result.discard_counter = q_.discard_counter();
+    result.priority_overrun_counter = q_.overrun_counter(true);
+    result.priority_discard_counter = q_.discard_counter(true);
+    result.msgs_processed = msgs_processed_.load(std::memory_order_relaxed);
+    result.bytes_processed = bytes_processed_.load(std::memory_order_relaxed);
+    return result;
+}
+
+void SPDLOG_INLINE thread_pool::set_priority_level(level::level_enum lvl) {
+    priority_level_.store(lvl, std::memory_order_relaxed);
+}
+
+level::level_enum SPDLOG_INLINE thread_pool::priority_level() const {
+    return static_cast<level::level_enum>(priority_level_.load(std::memory_order_relaxed));
+}
+
+size_t SPDLOG_INLINE thread_pool::priority_overrun_counter() { return q_.overrun_counter(true); }
+
+void SPDLOG_INLINE thread_pool::reset_priority_overrun_counter() {
+    q_.reset_overrun_counter(true);
+}
+
+size_t SPDLOG_INLINE thread_pool::priority_discard_counter() { return q_.discard_counter(true); }
+
+void SPDLOG_INLINE thread_pool::reset_priority_discard_counter() {
+    q_.reset_discard_counter(true);
+}
+
+void SPDLOG_INLINE thread_pool::set_spill_file(const filename_t &filename, size_t max_bytes) {
+    std::lock_guard<std::mutex> lock(spill_mutex_);
+    if (spill_owner_) {
+        throw_spdlog_ex("thread_pool::set_spill_file(): spill file already set");
+    }
+    spill_owner_.reset(new async_spill(filename, max_bytes));
+    spill_.store(spill_owner_.get(), std::memory_order_release);
+}
+
+void SPDLOG_INLINE thread_pool::set_wait_strategy(async_wait_strategy strategy,
+                                                  size_t spin_budget) {
+    q_.set_wait_strategy(strategy, spin_budget);
+}
+
 void SPDLOG_INLINE thread_pool::post_async_msg_(async_msg &&new_msg,
-                                                async_overflow_policy overflow_policy) {
+                                                async_overflow_policy overflow_policy,
+                                                bool priority) {
     if (overflow_policy == async_overflow_policy::block) {
-        q_.enqueue(std::move(new_msg));
+        q_.enqueue(std::move(new_msg), priority);
+    } else if (overflow_policy == async_overflow_policy::spill_to_disk) {
+        auto *spill = spill_.load(std::memory_order_acquire);
+        if (spill == nullptr) {
+            q_.enqueue(std::move(new_msg), priority);
+        } else if (spill->active() || !q_.try_enqueue(std::move(new_msg), priority)) {
+            // try_enqueue() leaves new_msg untouched on failure
+            spill_async_msg_(*spill, new_msg);
+        }
     } else if (overflow_policy == async_overflow_policy::overrun_oldest) {
-        q_.enqueue_nowait(std::move(new_msg));
+        q_.enqueue_nowait(std::move(new_msg), priority);
     } else {
         assert(overflow_policy == async_overflow_policy::discard_new);
-        q_.enqueue_if_have_room(std::move(new_msg));
+        q_.enqueue_if_have_room(std::move(new_msg), priority);
     }
 }
 
-void SPDLOG_INLINE thread_pool::worker_loop_() {
-    while (process_next_msg_()) {
+void SPDLOG_INLINE thread_pool::worker_loop_(size_t worker) {
+    while (process_next_msg_(worker)) {
     }
 }
 
 // process next message in the queue
 // return true if this thread should still be active (while no terminate msg
 // was received)
-bool SPDLOG_INLINE thread_pool::process_next_msg_() {
+bool SPDLOG_INLINE thread_pool::process_next_msg_(size_t worker) {
+    workers_[worker].progress.fetch_add(1, std::memory_order_release);
+    reclaim_loggers_(worker);
+
+    // spilled msgs are newer than everything in the queue, replay them once it drained
+    auto *spill = spill_.load(std::memory_order_acquire);
+    if (spill != nullptr && spill->active() && q_.size() == 0 && replay_spill_(worker, *spill)) {
+        return true;
+    }
+
     async_msg incoming_async_msg;
     q_.dequeue(incoming_async_msg);
 
     switch (incoming_async_msg.msg_type) {
         case async_msg_type::log: {
-            incoming_async_msg.worker_ptr->backend_sink_it_(incoming_async_msg);
+            dispatch_log_(worker, incoming_async_msg.logger_slot, incoming_async_msg,
+                          incoming_async_msg.enqueue_time);
             return true;
         }
         case async_msg_type::flush: {
-            incoming_async_msg.worker_ptr->backend_flush_();
+            dispatch_flush_(worker, incoming_async_msg.logger_slot);
+            return true;
+        }
+
+        case async_msg_type::replay: {
             return true;
         }
 
         case async_msg_type::terminate: {
+            if (spill != nullptr) {
+                replay_spill_(worker, *spill);
+            }
             return false;
         }
 
@@ -122,5 +463,62 @@ bool SPDLOG_INLINE thread_pool::process_next_msg_() {
     return true;
 }
 
+void SPDLOG_INLINE thread_pool::dispatch_log_(size_t worker,
+                                              size_t logger_slot,
+                                              const log_msg &msg,
+                                              std::chrono::steady_clock::time_point enqueue_time) {
+    workers_[worker].dispatching.store(logger_slot);
+    if (auto *logger = logger_at_(logger_slot)) {
+        using std::chrono::duration_cast;
+        using std::chrono::nanoseconds;
+        const auto dequeued = std::chrono::steady_clock::now();
+        logger->backend_sink_it_(msg);
+        const auto written = std::chrono::steady_clock::now();
+        logger->stats_.enqueue_to_dequeue.record(
+            static_cast<uint64_t>(duration_cast<nanoseconds>(dequeued - enqueue_time).count()));
+        logger->stats_.dequeue_to_written.record(
+            static_cast<uint64_t>(duration_cast<nanoseconds>(written - dequeued).count()));
+    }
+    workers_[worker].dispatching.store(async_msg::no_logger, std::memory_order_release);
+    workers_[worker].progress.fetch_add(1, std::memory_order_release);
+    msgs_processed_.fetch_add(1, std::memory_order_relaxed);
+    bytes_processed_.fetch_add(msg.payload.size(), std::memory_order_relaxed);
+}
+
+void SPDLOG_INLINE thread_pool::dispatch_flush_(size_t worker, size_t logger_slot) {
+    workers_[worker].dispatching.store(logger_slot);
+    if (auto *logger = logger_at_(logger_slot)) {
+        logger->backend_flush_();
+    }
+    workers_[worker].dispatching.store(async_msg::no_logger, std::memory_order_release);
+    workers_[worker].progress.fetch_add(1, std::memory_order_release);
+}
+
+void SPDLOG_INLINE thread_pool::spill_async_msg_(async_spill &spill, const async_msg &msg) {
+    if (spill.append(msg.msg_type, msg.logger_slot, msg.enqueue_time, msg)) {
+        // a worker might be parked on the (now empty) queue - wake it up to replay
+        q_.try_enqueue(async_msg(async_msg_type::replay));
+    }
+}
+
+// replay (in order) everything in the spill file.
+// return false if another worker is already replaying it.
+bool SPDLOG_INLINE thread_pool::replay_spill_(size_t worker, async_spill &spill) {
+    if (!spill.try_begin_replay()) {
+        return false;
+    }
+    async_spill::record rec;
+    while (spill.peek(rec)) {
+        if (rec.msg_type == async_msg_type::log) {
+            dispatch_log_(worker, rec.logger_slot, rec.msg, rec.enqueue_time);
+        } else if (rec.msg_type == async_msg_type::flush) {
+            dispatch_flush_(worker, rec.logger_slot);
+        }
+        spill.consume();
+    }
+    spill.end_replay();
+    return true;
+}
+
 }  // namespace details
 }  // namespace spdlog
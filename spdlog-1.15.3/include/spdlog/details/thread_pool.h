@@ -3,16 +3,31 @@
 
 #pragma once
 
-#include <spdlog/details/log_msg_buffer.h>
+#include <spdlog/details/async_spill.h>
+#include <spdlog/details/log_msg.h>
 #include <spdlog/details/mpmc_blocking_q.h>
 #include <spdlog/details/os.h>
 
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <thread>
 #include <vector>
 
+// bytes of logger name + payload stored inline in each queue slot (see tweakme.h)
+#ifndef SPDLOG_ASYNC_INLINE_MSG_SIZE
+    #define SPDLOG_ASYNC_INLINE_MSG_SIZE 256
+#endif
+
+// size of the thread pool's priority lane, 0 to disable it (see tweakme.h)
+#ifndef SPDLOG_ASYNC_PRIORITY_Q_SIZE
+    #define SPDLOG_ASYNC_PRIORITY_Q_SIZE 128
+#endif
+
 namespace spdlog {
 class async_logger;
 
@@ -20,51 +35,78 @@ namespace details {
 
 using async_logger_ptr = std::shared_ptr<spdlog::async_logger>;
 
-enum class async_msg_type { log, flush, terminate };
+enum class async_msg_type { log, flush, replay, terminate };
+
+// Pool of heap blocks for async messages too large to be stored inline in a queue slot.
+// Returned blocks are kept for reuse, so once the pool is warm, bursts of large messages
+// do not allocate.
+class SPDLOG_API async_arena {
+public:
+    static const size_t max_free_blocks = 64;
+
+    async_arena() = default;
+    async_arena(const async_arena &) = delete;
+    async_arena &operator=(const async_arena &) = delete;
+
+    memory_buf_t *acquire();
+    void release(memory_buf_t *block);
+
+private:
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<memory_buf_t>> free_blocks_;
+};
 
 // Async msg to move to/from the queue
-// Movable only. should never be copied
-struct async_msg : log_msg_buffer {
+// Movable only. should never be copied.
+// The logger name and payload live inline in the (preallocated) queue slot if they fit in
+// SPDLOG_ASYNC_INLINE_MSG_SIZE bytes, otherwise in a block borrowed from the pool's arena.
+// The originating logger is referenced by its thread pool slot.
+struct SPDLOG_API async_msg : log_msg {
+    static const size_t no_logger = static_cast<size_t>(-1);
+
     async_msg_type msg_type{async_msg_type::log};
-    async_logger_ptr worker_ptr;
+    size_t logger_slot{no_logger};
+    std::chrono::steady_clock::time_point enqueue_time;
 
     async_msg() = default;
-    ~async_msg() = default;
+    ~async_msg();
 
     // should only be moved in or out of the queue..
     async_msg(const async_msg &) = delete;
-
-// support for vs2013 move
-#if defined(_MSC_VER) && _MSC_VER <= 1800
-    async_msg(async_msg &&other)
-        : log_msg_buffer(std::move(other)),
-          msg_type(other.msg_type),
-          worker_ptr(std::move(other.worker_ptr)) {}
-
-    async_msg &operator=(async_msg &&other) {
-        *static_cast<log_msg_buffer *>(this) = std::move(other);
-        msg_type = other.msg_type;
-        worker_ptr = std::move(other.worker_ptr);
-        return *this;
-    }
-#else  // (_MSC_VER) && _MSC_VER <= 1800
-    async_msg(async_msg &&) = default;
-    async_msg &operator=(async_msg &&) = default;
-#endif
+    async_msg &operator=(const async_msg &) = delete;
+    async_msg(async_msg &&other) SPDLOG_NOEXCEPT;
+    async_msg &operator=(async_msg &&other) SPDLOG_NOEXCEPT;
 
     // construct from log_msg with given type
-    async_msg(async_logger_ptr &&worker, async_msg_type the_type, const details::log_msg &m)
-        : log_msg_buffer{m},
-          msg_type{the_type},
-          worker_ptr{std::move(worker)} {}
+    async_msg(size_t slot, async_msg_type the_type, const details::log_msg &m, async_arena &arena);
 
-    async_msg(async_logger_ptr &&worker, async_msg_type the_type)
-        : log_msg_buffer{},
-          msg_type{the_type},
-          worker_ptr{std::move(worker)} {}
+    async_msg(size_t slot, async_msg_type the_type)
+        : msg_type{the_type},
+          logger_slot{slot} {}
 
     explicit async_msg(async_msg_type the_type)
-        : async_msg{nullptr, the_type} {}
+        : async_msg{no_logger, the_type} {}
+
+private:
+    async_arena *arena_{nullptr};
+    memory_buf_t *block_{nullptr};
+    char inline_buf_[SPDLOG_ASYNC_INLINE_MSG_SIZE];
+
+    void take_storage_(async_msg &other) SPDLOG_NOEXCEPT;
+    void release_block_() SPDLOG_NOEXCEPT;
+    void update_string_views_(const char *data) SPDLOG_NOEXCEPT;
+};
+
+// Queue telemetry of a thread pool (see thread_pool::stats()).
+struct thread_pool_stats {
+    size_t queue_size = 0;
+    size_t queue_high_water_mark = 0;
+    size_t overrun_counter = 0;
+    size_t discard_counter = 0;
+    size_t priority_overrun_counter = 0;
+    size_t priority_discard_counter = 0;
+    uint64_t msgs_processed = 0;
+    uint64_t bytes_processed = 0;  // payload bytes
 };
 
 class SPDLOG_API thread_pool {
@@ -85,28 +127,131 @@ public:
     thread_pool(const thread_pool &) = delete;
     thread_pool &operator=(thread_pool &&) = delete;
 
-    void post_log(async_logger_ptr &&worker_ptr,
+    void post_log(size_t logger_slot,
                   const details::log_msg &msg,
                   async_overflow_policy overflow_policy);
-    void post_flush(async_logger_ptr &&worker_ptr, async_overflow_policy overflow_policy);
+    void post_flush(size_t logger_slot, async_overflow_policy overflow_policy);
+
+    // loggers are referenced from queued messages by slot instead of by shared_ptr.
+    // release_logger() doesn't wait for the queue: if messages of the logger may still be
+    // pending, the slot is handed to a copy of the logger (same sinks, levels and error
+    // handler) which writes them, and which a worker destroys once they are all done. it only
+    // waits for the workers to finish the message they may be writing to the logger, so the
+    // logger may be destroyed right after, also from a sink on a worker thread.
+    size_t register_logger(async_logger *logger);
+    void release_logger(size_t logger_slot);
+
     size_t overrun_counter();
     void reset_overrun_counter();
     size_t discard_counter();
     void reset_discard_counter();
     size_t queue_size();
+    size_t queue_high_water_mark();
+    void reset_queue_high_water_mark();
+
+    // snapshot of the counters above plus totals of msgs/bytes processed by the workers.
+    // rates can be derived from two snapshots.
+    thread_pool_stats stats();
+
+    // log msgs at or above this level go to a small separate lane which the workers always
+    // drain first, so errors are not stuck (or overrun) behind a backlog of debug msgs.
+    // level::off (the default) disables the priority lane.
+    // Opting in reorders the output: when the regular lane is backed up, a thread's err msg
+    // can be written before the info msgs that thread logged earlier.
+    void set_priority_level(level::level_enum lvl);
+    level::level_enum priority_level() const;
+    size_t priority_overrun_counter();
+    void reset_priority_overrun_counter();
+    size_t priority_discard_counter();
+    void reset_priority_discard_counter();
+
+    // how idle workers wait for messages. producers only pay for a wakeup when a
+    // worker is actually parked.
+    static const size_t default_spin_budget = 2000;
+    void set_wait_strategy(async_wait_strategy strategy, size_t spin_budget = default_spin_budget);
+
+    // memory mapped file used by async_overflow_policy::spill_to_disk. must be set once,
+    // before loggers with that policy log. without it, spill_to_disk behaves like block.
+    // when the spill file itself is full, producers block until room for their msg was
+    // replayed.
+    static const size_t default_spill_file_size = 64 * 1024 * 1024;
+    void set_spill_file(const filename_t &filename, size_t max_bytes = default_spill_file_size);
 
 private:
+    async_arena arena_;
     q_type q_;
+    std::atomic<int> priority_level_{level::off};
+    std::atomic<uint64_t> msgs_processed_{0};
+    std::atomic<uint64_t> bytes_processed_{0};
+
+    std::mutex spill_mutex_;
+    std::unique_ptr<async_spill> spill_owner_;
+    std::atomic<async_spill *> spill_{nullptr};
 
     std::vector<std::thread> threads_;
 
-    void post_async_msg_(async_msg &&new_msg, async_overflow_policy overflow_policy);
-    void worker_loop_();
+    // logger slots, in chunks that never move. the workers read the current directory of
+    // chunks without locking: it is replaced (under logger_slots_mutex_) when a chunk is
+    // added, and the old ones are kept until destruction.
+    static const size_t slots_per_chunk = 256;
+    struct slot_chunk {
+        std::atomic<async_logger *> loggers[slots_per_chunk];
+    };
+    using slot_directory = std::vector<slot_chunk *>;
+    std::mutex logger_slots_mutex_;
+    std::vector<std::unique_ptr<slot_chunk>> slot_chunks_;
+    std::vector<std::unique_ptr<slot_directory>> slot_directories_;
+    std::atomic<const slot_directory *> slot_directory_{nullptr};
+    std::vector<size_t> free_logger_slots_;
+
+    struct worker_state {
+        std::atomic<size_t> dispatching;  // slot of the msg being dispatched, no_logger if none
+        std::atomic<uint64_t> progress;   // bumped after each dispatch and each loop
+    };
+    std::unique_ptr<worker_state[]> workers_;
+
+    // copies of released loggers, serving the msgs they left in the queue or spill file
+    struct retired_logger {
+        size_t slot;
+        std::unique_ptr<async_logger> backend;
+        uint64_t pushed[2];              // msgs pushed to each queue lane at release
+        uint64_t spilled;                // records appended to the spill file at release
+        bool drained = false;            // all those msgs were dequeued
+        std::vector<uint64_t> progress;  // of each worker when drained was first seen
+    };
+    std::mutex retired_mutex_;
+    std::vector<retired_logger> retired_;
+    std::atomic<size_t> retired_count_{0};
+
+    async_logger *logger_at_(size_t logger_slot) const;
+    std::atomic<async_logger *> &slot_ref_(size_t logger_slot) const;
+    void add_slot_chunk_();
+    // slot msgs can't reach anymore: back to the free list
+    void free_slot_(size_t logger_slot);
+    // no msg of a logger released before can be pending if the queue is empty, the spill file
+    // replayed and all the workers but busy_workers wait for msgs
+    bool pool_idle_(size_t busy_workers);
+    // destroy the retired loggers whose msgs were all processed
+    void reclaim_loggers_(size_t worker);
+    void dispatch_log_(size_t worker,
+                       size_t logger_slot,
+                       const log_msg &msg,
+                       std::chrono::steady_clock::time_point enqueue_time);
+    void dispatch_flush_(size_t worker, size_t logger_slot);
+    void spill_async_msg_(async_spill &spill, const async_msg &msg);
+    bool replay_spill_(size_t worker, async_spill &spill);
+    // index of the calling worker thread, threads_.size() if not a worker
+    size_t worker_index_() const;
+
+    void post_async_msg_(async_msg &&new_msg,
+                         async_overflow_policy overflow_policy,
+                         bool priority = false);
+    void worker_loop_(size_t worker);
 
     // process next message in the queue
     // return true if this thread should still be active (while no terminate msg
     // was received)
-    bool process_next_msg_();
+    bool process_next_msg_(size_t worker);
 };
 
 }  // namespace details
@@ -0,0 +1,66 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#ifndef SPDLOG_HEADER_ONLY
+    #include <spdlog/details/tsc_clock.h>
+#endif
+
+namespace spdlog {
+namespace details {
+
+SPDLOG_INLINE tsc_clock::tsc_clock() {
+    using std::chrono::duration_cast;
+    using std::chrono::nanoseconds;
+    using std::chrono::steady_clock;
+
+    // the wall clock reference is taken between two counter reads
+    const auto ticks_before = ticks();
+    const auto wall = log_clock::now();
+    const auto ticks_after = ticks();
+    base_ticks_ = ticks_before + (ticks_after - ticks_before) / 2;
+    base_wall_ns_ =
+        static_cast<int64_t>(duration_cast<nanoseconds>(wall.time_since_epoch()).count());
+
+#ifdef SPDLOG_HAS_RDTSC
+    const auto steady_start = steady_clock::now();
+    const auto ticks_start = ticks();
+    auto steady_end = steady_start;
+    while (steady_end - steady_start < std::chrono::milliseconds(10)) {
+        steady_end = steady_clock::now();
+    }
+    const auto elapsed_ticks = ticks() - ticks_start;
+    const auto elapsed_ns = duration_cast<nanoseconds>(steady_end - steady_start).count();
+    ns_per_tick_ = elapsed_ticks > 0 ? static_cast<double>(elapsed_ns) /
+                                           static_cast<double>(elapsed_ticks)
+                                     : 1.0;
+#else
+    ns_per_tick_ = 1.0;
+#endif
+}
+
+SPDLOG_INLINE const tsc_clock &tsc_clock::instance() {
+    static const tsc_clock s_instance;
+    return s_instance;
+}
+
+SPDLOG_INLINE int64_t tsc_clock::to_nanos(uint64_t ticks) const SPDLOG_NOEXCEPT {
+    const auto delta = static_cast<int64_t>(ticks - base_ticks_);
+    return static_cast<int64_t>(static_cast<double>(delta) * ns_per_tick_);
+}
+
+SPDLOG_INLINE int64_t tsc_clock::to_nanos(log_clock::time_point time) const SPDLOG_NOEXCEPT {
+    const auto wall_ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+    return static_cast<int64_t>(wall_ns) - base_wall_ns_;
+}
+
+SPDLOG_INLINE log_clock::time_point tsc_clock::to_time_point(uint64_t ticks) const
+    SPDLOG_NOEXCEPT {
+    const std::chrono::nanoseconds wall_ns(base_wall_ns_ + to_nanos(ticks));
+    return log_clock::time_point(std::chrono::duration_cast<log_clock::duration>(wall_ns));
+}
+
+}  // namespace details
+}  // namespace spdlog
@@ -0,0 +1,68 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+// Cheap monotonic clock for log timestamps (see SPDLOG_TSC_CLOCK in tweakme.h).
+//
+// ticks() reads the CPU time stamp counter on x86 (a few cycles, no system
+// call) and steady_clock nanoseconds elsewhere. On first use the counter is
+// calibrated once against steady_clock over ~10ms, together with a wall clock
+// reference, after which ticks convert to nanoseconds or log_clock time points
+// with a multiply and an add. Requires an invariant TSC (constant_tsc and
+// nonstop_tsc in /proc/cpuinfo), which all recent x86 CPUs have.
+
+#include <spdlog/common.h>
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    #define SPDLOG_HAS_RDTSC
+    #ifdef _MSC_VER
+        #include <intrin.h>
+    #else
+        #include <x86intrin.h>
+    #endif
+#endif
+
+namespace spdlog {
+namespace details {
+
+class SPDLOG_API tsc_clock {
+public:
+    tsc_clock(const tsc_clock &) = delete;
+    tsc_clock &operator=(const tsc_clock &) = delete;
+
+    static uint64_t ticks() SPDLOG_NOEXCEPT {
+#ifdef SPDLOG_HAS_RDTSC
+        return static_cast<uint64_t>(__rdtsc());
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         std::chrono::steady_clock::now().time_since_epoch())
+                                         .count());
+#endif
+    }
+
+    // nanoseconds since the calibration
+    int64_t to_nanos(uint64_t ticks) const SPDLOG_NOEXCEPT;
+    // same, for a time not taken from the counter (off by any wall clock adjustment since)
+    int64_t to_nanos(log_clock::time_point time) const SPDLOG_NOEXCEPT;
+    log_clock::time_point to_time_point(uint64_t ticks) const SPDLOG_NOEXCEPT;
+
+    static const tsc_clock &instance();
+
+private:
+    uint64_t base_ticks_;
+    int64_t base_wall_ns_;  // log_clock time at base_ticks_
+    double ns_per_tick_;
+
+    tsc_clock();
+};
+
+}  // namespace details
+}  // namespace spdlog
+
+#ifdef SPDLOG_HEADER_ONLY
+    #include "tsc_clock-inl.h"
+#endif
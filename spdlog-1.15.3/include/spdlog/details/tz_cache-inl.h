@@ -0,0 +1,178 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#ifndef SPDLOG_HEADER_ONLY
+    #include <spdlog/details/tz_cache.h>
+#endif
+
+#include <spdlog/details/os.h>
+
+namespace spdlog {
+namespace details {
+
+SPDLOG_INLINE tz_cache::tz_cache()
+    : gmt_ref_tm_(os::gmtime(0)) {}
+
+// Never destroyed, so loggers that format while other statics are being torn
+// down (e.g. the async thread pool flushing at exit) can still use it.
+SPDLOG_INLINE tz_cache &tz_cache::instance() {
+    static tz_cache *s_instance = new tz_cache();
+    return *s_instance;
+}
+
+SPDLOG_INLINE std::tm tz_cache::localtime(std::time_t time_tt) {
+    const zone *z = zone_for_(time_tt);
+    if (z == nullptr) {
+        return os::localtime(time_tt);
+    }
+    return to_tm_(time_tt, z->offset, z->ref_tm);
+}
+
+SPDLOG_INLINE std::tm tz_cache::gmtime(std::time_t time_tt) const {
+    return to_tm_(time_tt, 0, gmt_ref_tm_);
+}
+
+SPDLOG_INLINE std::time_t tz_cache::mktime(const std::tm &local_tm) {
+    const zone *z = zone_for_(::time(nullptr));
+    // tm_isdst picks the instance of a local time repeated when dst ends
+    if (z != nullptr && (local_tm.tm_isdst < 0 || local_tm.tm_isdst == z->ref_tm.tm_isdst)) {
+        const auto time_tt = static_cast<std::time_t>(local_seconds_(local_tm) - z->offset);
+        if (time_tt >= z->from && time_tt < z->until) {
+            return time_tt;
+        }
+    }
+    std::tm tm_copy = local_tm;
+    return std::mktime(&tm_copy);
+}
+
+SPDLOG_INLINE void tz_cache::refresh() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    load_zone_(::time(nullptr));
+}
+
+SPDLOG_INLINE const tz_cache::zone *tz_cache::zone_for_(std::time_t time_tt) {
+    const zone *z = zone_.load(std::memory_order_acquire);
+    if (z != nullptr && time_tt >= z->from && time_tt < z->until) {
+        return z;
+    }
+
+    // follow the wall clock only, so looking up a time in another period
+    // (e.g. next rotation time across a DST change) doesn't reload every time.
+    std::lock_guard<std::mutex> lock(mutex_);
+    z = zone_.load(std::memory_order_relaxed);
+    const auto now = ::time(nullptr);
+    if (z == nullptr || now < z->from || now >= z->until) {
+        z = load_zone_(now);
+    }
+    if (time_tt >= z->from && time_tt < z->until) {
+        return z;
+    }
+    return nullptr;
+}
+
+// find the period around now in which the offset and dst flag stay the same.
+// probe a day at a time for up to max_days, then bisect to the exact second.
+SPDLOG_INLINE const tz_cache::zone *tz_cache::load_zone_(std::time_t now) {
+    const std::time_t day = 24 * 3600;
+    const int max_days = 400;
+
+    auto new_zone = details::make_unique<zone>();
+    new_zone->offset = offset_at_(now, new_zone->ref_tm);
+    const auto isdst = new_zone->ref_tm.tm_isdst;
+
+    auto same = [&](std::time_t t) {
+        std::tm tm;
+        return offset_at_(t, tm) == new_zone->offset && tm.tm_isdst == isdst;
+    };
+    auto bisect = [&](std::time_t same_t, std::time_t other_t) {
+        // returns the boundary second on the "other" side
+        while (same_t + 1 != other_t && same_t - 1 != other_t) {
+            const auto mid = same_t + (other_t - same_t) / 2;
+            if (same(mid)) {
+                same_t = mid;
+            } else {
+                other_t = mid;
+            }
+        }
+        return other_t;
+    };
+
+    new_zone->until = now + max_days * day;
+    for (int i = 1; i <= max_days; i++) {
+        if (!same(now + i * day)) {
+            new_zone->until = bisect(now + (i - 1) * day, now + i * day);
+            break;
+        }
+    }
+    new_zone->from = now - day;
+    if (!same(new_zone->from)) {
+        new_zone->from = bisect(now, new_zone->from) + 1;
+    }
+
+    const zone *rv = new_zone.get();
+    zones_.push_back(std::move(new_zone));
+    zone_.store(rv, std::memory_order_release);
+    return rv;
+}
+
+SPDLOG_INLINE std::int64_t tz_cache::offset_at_(std::time_t time_tt, std::tm &local_tm) {
+    local_tm = os::localtime(time_tt);
+    return local_seconds_(local_tm) - static_cast<std::int64_t>(time_tt);
+}
+
+// days since 1970-01-01 of the given proleptic gregorian date (m in 1-12).
+// see http://howardhinnant.github.io/date_algorithms.html
+SPDLOG_INLINE std::int64_t tz_cache::days_from_civil_(std::int64_t y, unsigned m, unsigned d) {
+    y -= m <= 2 ? 1 : 0;
+    const std::int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const auto yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<std::int64_t>(doe) - 719468;
+}
+
+SPDLOG_INLINE std::int64_t tz_cache::local_seconds_(const std::tm &tm) {
+    const auto days = days_from_civil_(tm.tm_year + 1900, static_cast<unsigned>(tm.tm_mon + 1),
+                                       static_cast<unsigned>(tm.tm_mday));
+    return days * 86400 + tm.tm_hour * 3600 + tm.tm_min * 60 + tm.tm_sec;
+}
+
+SPDLOG_INLINE std::tm tz_cache::to_tm_(std::time_t time_tt,
+                                       std::int64_t offset,
+                                       const std::tm &ref_tm) {
+    const std::int64_t secs = static_cast<std::int64_t>(time_tt) + offset;
+    std::int64_t days = secs / 86400;
+    std::int64_t rem = secs % 86400;
+    if (rem < 0) {
+        rem += 86400;
+        days--;
+    }
+
+    std::tm tm = ref_tm;
+    tm.tm_hour = static_cast<int>(rem / 3600);
+    tm.tm_min = static_cast<int>(rem % 3600 / 60);
+    tm.tm_sec = static_cast<int>(rem % 60);
+    tm.tm_wday = static_cast<int>(((days + 4) % 7 + 7) % 7);  // 1970-01-01 was a thursday
+
+    // civil date from days, inverse of days_from_civil_()
+    const std::int64_t z = days + 719468;
+    const std::int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const auto doe = static_cast<unsigned>(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    const unsigned d = doy - (153 * mp + 2) / 5 + 1;
+    const unsigned m = mp < 10 ? mp + 3 : mp - 9;
+    const std::int64_t y = static_cast<std::int64_t>(yoe) + era * 400 + (m <= 2 ? 1 : 0);
+
+    tm.tm_year = static_cast<int>(y - 1900);
+    tm.tm_mon = static_cast<int>(m - 1);
+    tm.tm_mday = static_cast<int>(d);
+    tm.tm_yday = static_cast<int>(days - days_from_civil_(y, 1, 1));
+    return tm;
+}
+
+}  // namespace details
+}  // namespace spdlog
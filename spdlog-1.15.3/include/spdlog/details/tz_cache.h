@@ -0,0 +1,75 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+// Cached time zone offset for converting log times to broken-down time.
+//
+// localtime_r() (and gmtime_r() on glibc) takes a process wide lock and may
+// stat the tz database, which shows up as contention when many threads format
+// log times. The cache asks the C library once for the UTC offset in effect
+// and searches for the period in which it stays the same (i.e. the surrounding
+// DST transitions). Times inside that period are converted lock free with plain
+// arithmetic; the period is recomputed once the wall clock leaves it, or on
+// refresh() (e.g. after the TZ environment variable changed). Other times fall
+// back to details::os::localtime().
+
+#include <spdlog/common.h>
+
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace spdlog {
+namespace details {
+
+class SPDLOG_API tz_cache {
+public:
+    tz_cache(const tz_cache &) = delete;
+    tz_cache &operator=(const tz_cache &) = delete;
+
+    std::tm localtime(std::time_t time_tt);
+    std::tm gmtime(std::time_t time_tt) const;
+
+    // inverse of localtime() for the given local broken-down time, like std::mktime().
+    std::time_t mktime(const std::tm &local_tm);
+
+    // re-read the time zone from the C library
+    void refresh();
+
+    static tz_cache &instance();
+
+private:
+    // period [from, until) in which the offset does not change
+    struct zone {
+        std::time_t from;
+        std::time_t until;
+        std::int64_t offset;  // seconds east of UTC
+        std::tm ref_tm;       // supplies tm_isdst and the platform specific fields
+    };
+
+    std::atomic<const zone *> zone_{nullptr};
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<zone>> zones_;  // published zones are never freed
+    std::tm gmt_ref_tm_;
+
+    tz_cache();
+
+    const zone *zone_for_(std::time_t time_tt);
+    const zone *load_zone_(std::time_t now);
+
+    static std::int64_t offset_at_(std::time_t time_tt, std::tm &local_tm);
+    static std::int64_t days_from_civil_(std::int64_t y, unsigned m, unsigned d);
+    static std::int64_t local_seconds_(const std::tm &tm);
+    static std::tm to_tm_(std::time_t time_tt, std::int64_t offset, const std::tm &ref_tm);
+};
+
+}  // namespace details
+}  // namespace spdlog
+
+#ifdef SPDLOG_HEADER_ONLY
+    #include "tz_cache-inl.h"
+#endif
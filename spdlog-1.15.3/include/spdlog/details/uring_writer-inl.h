@@ -0,0 +1,348 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#ifndef SPDLOG_HEADER_ONLY
+    #include <spdlog/details/uring_writer.h>
+#endif
+
+#ifdef SPDLOG_HAS_IO_URING
+
+    #include <algorithm>
+    #include <cerrno>
+    #include <cstdint>
+    #include <cstring>
+    #include <thread>
+
+    #include <linux/io_uring.h>
+    #include <sys/mman.h>
+    #include <sys/uio.h>
+    #include <unistd.h>
+
+namespace spdlog {
+namespace details {
+
+namespace uring {
+// at most a write and an fsync are in flight
+static const unsigned queue_depth = 4;
+
+inline int enter(int ring_fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    int ret;
+    do {
+        ret = static_cast<int>(::syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete,
+                                         flags, nullptr, 0));
+    } while (ret < 0 && errno == EINTR);
+    return ret;
+}
+
+template <typename T>
+T *at(void *base, unsigned offset) {
+    return reinterpret_cast<T *>(static_cast<char *>(base) + offset);
+}
+}  // namespace uring
+
+SPDLOG_INLINE uring_writer::uring_writer(size_t buffer_size, size_t buffer_count)
+    : buffer_size_(buffer_size),
+      buffer_count_((std::max)(buffer_count, size_t{2})) {
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    ring_fd_ = static_cast<int>(::syscall(__NR_io_uring_setup, uring::queue_depth, &params));
+    if (ring_fd_ < 0) {
+        ring_fd_ = -1;
+        return;
+    }
+    // "current position" writes (off -1) need 5.6, which also brought IORING_OP_WRITE
+    if ((params.features & IORING_FEAT_RW_CUR_POS) == 0) {
+        close_ring_();
+        return;
+    }
+
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+        sq_ring_size_ = (std::max)(sq_ring_size_, cq_ring_size_);
+    }
+    sq_ring_ = ::mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      ring_fd_, IORING_OFF_SQ_RING);
+    if (sq_ring_ == MAP_FAILED) {
+        sq_ring_ = nullptr;
+        close_ring_();
+        return;
+    }
+    if (single_mmap) {
+        cq_ring_ = sq_ring_;
+        cq_ring_size_ = 0;
+    } else {
+        cq_ring_ = ::mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING);
+        if (cq_ring_ == MAP_FAILED) {
+            cq_ring_ = nullptr;
+            close_ring_();
+            return;
+        }
+    }
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    void *sqes = ::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                        ring_fd_, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        close_ring_();
+        return;
+    }
+    sqes_ = static_cast<io_uring_sqe *>(sqes);
+
+    sq_tail_ = uring::at<unsigned>(sq_ring_, params.sq_off.tail);
+    sq_mask_ = uring::at<unsigned>(sq_ring_, params.sq_off.ring_mask);
+    sq_array_ = uring::at<unsigned>(sq_ring_, params.sq_off.array);
+    cq_head_ = uring::at<unsigned>(cq_ring_, params.cq_off.head);
+    cq_tail_ = uring::at<unsigned>(cq_ring_, params.cq_off.tail);
+    cq_mask_ = uring::at<unsigned>(cq_ring_, params.cq_off.ring_mask);
+    cqes_ = uring::at<io_uring_cqe>(cq_ring_, params.cq_off.cqes);
+
+    storage_.reset(new char[buffer_size_ * buffer_count_]);
+    buffers_.reset(new buffer[buffer_count_]);
+    std::unique_ptr<iovec[]> iovs(new iovec[buffer_count_]);
+    for (size_t i = 0; i < buffer_count_; i++) {
+        buffers_[i].data = storage_.get() + i * buffer_size_;
+        buffers_[i].size = 0;
+        iovs[i].iov_base = buffers_[i].data;
+        iovs[i].iov_len = buffer_size_;
+    }
+    // may fail on RLIMIT_MEMLOCK with older kernels: plain writes then
+    fixed_buffers_ = ::syscall(__NR_io_uring_register, ring_fd_, IORING_REGISTER_BUFFERS,
+                               iovs.get(), static_cast<unsigned>(buffer_count_)) == 0;
+}
+
+SPDLOG_INLINE uring_writer::~uring_writer() {
+    if (ok()) {
+        // the kernel may still use the buffers
+        while ((in_flight_ || fsync_in_flight_) && reap_(true)) {
+        }
+        if (in_flight_ || fsync_in_flight_) {
+            // can't wait for it: leak the buffers rather than let the kernel read reused memory
+            storage_.release();
+        }
+    }
+    close_ring_();
+}
+
+SPDLOG_INLINE void uring_writer::set_fd(int fd) { fd_ = fd; }
+
+SPDLOG_INLINE bool uring_writer::write(const char *data, size_t size) {
+    reap_(false);
+    while (size > 0) {
+        buffer &current = buffer_at_(used_ - 1);
+        if (current.size == buffer_size_) {
+            // hand the full buffer over, wait for the disk only if no buffer is left
+            while (used_ == buffer_count_ && reap_(true)) {
+            }
+            if (used_ == buffer_count_) {
+                return check_error_();
+            }
+            buffer_at_(used_).size = 0;
+            used_++;
+            if (!in_flight_ && !fsync_in_flight_) {
+                submit_front_();
+            }
+            continue;
+        }
+        const size_t chunk = (std::min)(size, buffer_size_ - current.size);
+        std::memcpy(current.data + current.size, data, chunk);
+        current.size += chunk;
+        data += chunk;
+        size -= chunk;
+    }
+    return check_error_();
+}
+
+SPDLOG_INLINE bool uring_writer::flush() {
+    // the full buffers go one after the other, the one being filled last
+    while ((used_ > 1 || fsync_in_flight_) && reap_(true)) {
+    }
+    if (used_ > 1 || fsync_in_flight_) {
+        return check_error_();
+    }
+    if (buffer_at_(0).size > 0) {
+        if (!in_flight_) {
+            submit_front_();
+        }
+        while (in_flight_ && reap_(true)) {
+        }
+    }
+    return check_error_();
+}
+
+SPDLOG_INLINE bool uring_writer::sync() {
+    if (!flush()) {
+        return false;
+    }
+    if (in_flight_) {
+        return check_error_();  // flush() couldn't wait for the write
+    }
+    submit_(IORING_OP_FSYNC, nullptr, 0, 0);
+    fsync_in_flight_ = true;
+    while (fsync_in_flight_ && reap_(true)) {
+    }
+    return check_error_();
+}
+
+SPDLOG_INLINE void uring_writer::submit_front_() {
+    const size_t index = first_ % buffer_count_;
+    const buffer &front = buffers_[index];
+    submit_(fixed_buffers_ ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE,
+            front.data + in_flight_offset_, front.size - in_flight_offset_,
+            static_cast<unsigned short>(index));
+    in_flight_ = true;
+}
+
+SPDLOG_INLINE void uring_writer::submit_(unsigned char opcode,
+                                         const char *data,
+                                         size_t size,
+                                         unsigned short buf_index) {
+    const unsigned tail = *sq_tail_;  // only we write the tail
+    const unsigned index = tail & *sq_mask_;
+    io_uring_sqe &sqe = sqes_[index];
+    std::memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = opcode;
+    sqe.fd = fd_;
+    if (opcode != IORING_OP_FSYNC) {
+        sqe.off = ~uint64_t{0};  // current file position (the end, O_APPEND)
+    }
+    sqe.addr = reinterpret_cast<uint64_t>(data);
+    sqe.len = static_cast<unsigned>((std::min)(size, size_t{1} << 30));
+    sqe.buf_index = buf_index;
+    sq_array_[index] = index;
+    __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+    unsubmitted_++;
+    const int submitted = uring::enter(ring_fd_, unsubmitted_, 0, 0);
+    // on failure the entry stays queued and goes with the next enter
+    if (submitted > 0) {
+        unsubmitted_ -= static_cast<unsigned>(submitted);
+    }
+}
+
+SPDLOG_INLINE bool uring_writer::reap_(bool wait) {
+    for (;;) {
+        unsigned head = *cq_head_;  // only we write the head
+        const unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+        if (head != tail) {
+            while (head != tail) {
+                const int res = cqes_[head & *cq_mask_].res;
+                head++;
+                __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+                on_complete_(res);
+            }
+            return true;
+        }
+        if (!wait) {
+            return true;
+        }
+        const int submitted = uring::enter(ring_fd_, unsubmitted_, 1, IORING_ENTER_GETEVENTS);
+        if (submitted >= 0) {
+            unsubmitted_ -= static_cast<unsigned>(submitted);
+            continue;
+        }
+        if (errno == EAGAIN || errno == EBUSY) {
+            // out of kernel resources, or completions to reap first: try again
+            std::this_thread::yield();
+            continue;
+        }
+        error_ = errno;
+        // a single operation is in flight at a time. if the kernel didn't take it, take its
+        // entry back: it is as if it was never submitted.
+        if (unsubmitted_ > 0) {
+            __atomic_store_n(sq_tail_, *sq_tail_ - unsubmitted_, __ATOMIC_RELEASE);
+            unsubmitted_ = 0;
+            in_flight_ = false;
+            fsync_in_flight_ = false;
+        }
+        // drop the buffers never submitted, like failed writes. the kernel may still read the
+        // one in flight: it stays until its completion is reaped, and a new one is filled.
+        for (size_t i = in_flight_ ? 1 : 0; i < used_; i++) {
+            buffer_at_(i).size = 0;
+        }
+        if (in_flight_) {
+            buffer_at_(1).size = 0;
+            used_ = 2;
+        } else {
+            in_flight_offset_ = 0;
+            used_ = 1;
+        }
+        return false;
+    }
+}
+
+SPDLOG_INLINE void uring_writer::on_complete_(int res) {
+    if (fsync_in_flight_) {
+        fsync_in_flight_ = false;
+        if (res < 0) {
+            error_ = -res;
+        }
+        if (used_ > 1) {
+            submit_front_();  // buffers filled meanwhile
+        }
+        return;
+    }
+
+    in_flight_ = false;
+    buffer &front = buffer_at_(0);
+    if (res == -EINTR || res == -EAGAIN) {
+        submit_front_();
+        return;
+    }
+    if (res <= 0) {
+        // on failure the buffer is dropped, like a failed fwrite
+        error_ = res < 0 ? -res : EIO;
+        in_flight_offset_ = front.size;
+    } else {
+        in_flight_offset_ += static_cast<size_t>(res);
+    }
+    if (in_flight_offset_ < front.size) {
+        submit_front_();  // short write
+        return;
+    }
+
+    front.size = 0;
+    in_flight_offset_ = 0;
+    first_ = (first_ + 1) % buffer_count_;
+    if (--used_ == 0) {
+        used_ = 1;  // flush() submitted the buffer being filled
+    }
+    if (used_ > 1) {
+        submit_front_();
+    }
+}
+
+SPDLOG_INLINE bool uring_writer::check_error_() {
+    if (error_ == 0) {
+        return true;
+    }
+    errno = error_;
+    error_ = 0;
+    return false;
+}
+
+SPDLOG_INLINE void uring_writer::close_ring_() {
+    if (sqes_ != nullptr) {
+        ::munmap(sqes_, sqes_size_);
+        sqes_ = nullptr;
+    }
+    if (cq_ring_ != nullptr && cq_ring_ != sq_ring_) {
+        ::munmap(cq_ring_, cq_ring_size_);
+    }
+    cq_ring_ = nullptr;
+    if (sq_ring_ != nullptr) {
+        ::munmap(sq_ring_, sq_ring_size_);
+        sq_ring_ = nullptr;
+    }
+    if (ring_fd_ != -1) {
+        ::close(ring_fd_);
+        ring_fd_ = -1;
+    }
+}
+
+}  // namespace details
+}  // namespace spdlog
+
+#endif  // SPDLOG_HAS_IO_URING
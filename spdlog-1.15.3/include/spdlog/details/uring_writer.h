@@ -0,0 +1,116 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+// Asynchronous file writes through io_uring (see SPDLOG_FILE_IO_URING in tweakme.h).
+//
+// Bytes are collected in a small set of buffers registered with the kernel.
+// A full buffer is submitted as a write and the next one is filled meanwhile,
+// so the caller (typically the async thread pool worker) only blocks when all
+// buffers are waiting for the disk. Writes are issued one at a time, in order,
+// which keeps the O_APPEND semantics of the log file.
+// A failed write is reported (false, errno set) by the call that sees its completion.
+//
+// Linux only, using the raw system calls (liburing is not required). Where
+// io_uring is not available at run time (old kernel, seccomp, ...) ok()
+// returns false and the caller writes by itself.
+
+#include <spdlog/common.h>
+
+#if defined(SPDLOG_FILE_IO_URING) && defined(SPDLOG_FILE_BUFFER_SIZE) && defined(__linux__) && \
+    defined(__has_include)
+    #if __has_include(<linux/io_uring.h>)
+        #include <sys/syscall.h>
+        #if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter) && \
+            defined(__NR_io_uring_register)
+            #define SPDLOG_HAS_IO_URING
+        #endif
+    #endif
+#endif
+
+#ifdef SPDLOG_HAS_IO_URING
+
+    #include <memory>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace spdlog {
+namespace details {
+
+class SPDLOG_API uring_writer {
+public:
+    uring_writer(size_t buffer_size, size_t buffer_count);
+    uring_writer(const uring_writer &) = delete;
+    uring_writer &operator=(const uring_writer &) = delete;
+    ~uring_writer();
+
+    // false if io_uring could not be set up
+    bool ok() const { return ring_fd_ != -1; }
+
+    // the file to write to. flush() before switching to another one.
+    void set_fd(int fd);
+    bool write(const char *data, size_t size);
+    // wait until everything written so far reached the kernel
+    bool flush();
+    // flush, then fsync through the ring
+    bool sync();
+
+private:
+    struct buffer {
+        char *data;
+        size_t size;
+    };
+
+    int ring_fd_ = -1;
+    int fd_ = -1;
+    bool fixed_buffers_ = false;  // buffers registered with the kernel
+
+    void *sq_ring_ = nullptr;
+    size_t sq_ring_size_ = 0;
+    void *cq_ring_ = nullptr;
+    size_t cq_ring_size_ = 0;
+    io_uring_sqe *sqes_ = nullptr;
+    size_t sqes_size_ = 0;
+    unsigned *sq_tail_ = nullptr;
+    unsigned *sq_mask_ = nullptr;
+    unsigned *sq_array_ = nullptr;
+    unsigned *cq_head_ = nullptr;
+    unsigned *cq_tail_ = nullptr;
+    unsigned *cq_mask_ = nullptr;
+    io_uring_cqe *cqes_ = nullptr;
+
+    std::unique_ptr<char[]> storage_;
+    std::unique_ptr<buffer[]> buffers_;
+    size_t buffer_size_;
+    size_t buffer_count_;
+    // buffers in use form a fifo: [first_, first_ + used_), the last one is being filled.
+    // the first one is in flight when in_flight_ is set, from in_flight_offset_ on.
+    size_t first_ = 0;
+    size_t used_ = 1;
+    bool in_flight_ = false;
+    bool fsync_in_flight_ = false;
+    size_t in_flight_offset_ = 0;
+    unsigned unsubmitted_ = 0;  // queued entries the kernel didn't take yet
+    int error_ = 0;
+
+    buffer &buffer_at_(size_t i) { return buffers_[(first_ + i) % buffer_count_]; }
+    void submit_front_();
+    void submit_(unsigned char opcode, const char *data, size_t size, unsigned short buf_index);
+    // process the completions, waiting for one if none is there yet and wait is set.
+    // false if the kernel can't be waited for (error_ is set). the operation in flight, if
+    // the kernel has it, stays in flight: its buffer isn't reused until it completes.
+    bool reap_(bool wait);
+    void on_complete_(int res);
+    bool check_error_();
+    void close_ring_();
+};
+
+}  // namespace details
+}  // namespace spdlog
+
+    #ifdef SPDLOG_HEADER_ONLY
+        #include "uring_writer-inl.h"
+    #endif
+#endif  // SPDLOG_HAS_IO_URING
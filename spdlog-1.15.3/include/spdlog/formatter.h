@@ -6,6 +6,8 @@
 #include <spdlog/details/log_msg.h>
 #include <spdlog/fmt/fmt.h>
 
+#include <string>
+
 namespace spdlog {
 
 class formatter {
@@ -13,5 +15,9 @@ public:
     virtual ~formatter() = default;
     virtual void format(const details::log_msg &msg, memory_buf_t &dest) = 0;
     virtual std::unique_ptr<formatter> clone() const = 0;
+
+    // Formatters with equal non empty signatures produce identical output for
+    // any message, which lets a logger format once for several sinks.
+    virtual std::string signature() const { return std::string(); }
 };
 }  // namespace spdlog
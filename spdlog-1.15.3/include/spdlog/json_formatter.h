@@ -0,0 +1,70 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+//
+// Formats each message as one line of JSON (ndjson), e.g.
+// {"time":"2024-01-02T03:04:05.678+01:00","level":"info","logger":"app","thread":1234,
+//  "file":"main.cpp","line":42,"func":"main","app":"demo","mdc":{"req":"7"},"msg":"hello"}
+//
+// Source location is written only if present, fields added with add_field() are
+// written for every message and the mdc object only if the thread has mdc values.
+// Strings are escaped with an SSE2/AVX2 scanner that skips runs of plain
+// characters 16/32 bytes at a time; the 16 byte blocks that have escapes are
+// expanded from a table of the escape sequences.
+//
+
+#include <spdlog/common.h>
+#include <spdlog/details/log_msg.h>
+#include <spdlog/details/os.h>
+#include <spdlog/formatter.h>
+
+#include <array>
+#include <chrono>
+#include <memory>
+#include <string>
+
+namespace spdlog {
+namespace details {
+
+// append str to dest with json string escaping (without the enclosing quotes).
+SPDLOG_API void json_escape(string_view_t str, memory_buf_t &dest);
+
+}  // namespace details
+
+class SPDLOG_API json_formatter final : public formatter {
+public:
+    explicit json_formatter(pattern_time_type time_type = pattern_time_type::local,
+                            std::string eol = spdlog::details::os::default_eol);
+
+    json_formatter(const json_formatter &other) = delete;
+    json_formatter &operator=(const json_formatter &other) = delete;
+
+    // add a constant field written with every message
+    json_formatter &add_field(string_view_t key, string_view_t value);
+
+    void format(const details::log_msg &msg, memory_buf_t &dest) override;
+    std::unique_ptr<formatter> clone() const override;
+    std::string signature() const override;
+
+private:
+    pattern_time_type pattern_time_type_;
+    std::string eol_;
+    std::string fields_;  // pre rendered ,"key":"value" pairs
+    std::string closing_;
+    std::array<std::string, level::n_levels> level_fields_;
+
+    // rendered once per second: ["time":"YYYY-MM-DDTHH:MM:SS.] and the utc offset
+    std::chrono::seconds cache_timestamp_{-1};
+    memory_buf_t cached_time_prefix_;
+    memory_buf_t cached_time_suffix_;
+
+    void update_time_cache_(const details::log_msg &msg);
+};
+
+}  // namespace spdlog
+
+#ifdef SPDLOG_HEADER_ONLY
+    #include "json_formatter-inl.h"
+#endif
@@ -133,9 +133,11 @@ SPDLOG_INLINE void logger::log_it_(const spdlog::details::log_msg &log_msg,
 }
 
 SPDLOG_INLINE void logger::sink_it_(const details::log_msg &msg) {
+    memory_buf_t formatted;
+    uint64_t formatted_key = 0;
     for (auto &sink : sinks_) {
         if (sink->should_log(msg.level)) {
-            SPDLOG_TRY { sink->log(msg); }
+            SPDLOG_TRY { sink_shared_(*sink, msg, formatted, formatted_key); }
             SPDLOG_LOGGER_CATCH(msg.source)
         }
     }
@@ -145,6 +147,26 @@ SPDLOG_INLINE void logger::sink_it_(const details::log_msg &msg) {
     }
 }
 
+SPDLOG_INLINE void logger::sink_shared_(sinks::sink &sink,
+                                        const details::log_msg &msg,
+                                        memory_buf_t &formatted,
+                                        uint64_t &formatted_key) {
+    const auto key = sink.format_key();
+    if (key == 0) {
+        sink.log(msg);
+    } else if (key == formatted_key) {
+        sink.log_formatted(msg, formatted);
+    } else {
+        formatted.clear();
+        formatted_key = 0;
+        msg.color_range_start = 0;
+        msg.color_range_end = 0;
+        sink.log_and_format(msg, formatted);
+        // nothing formatted if the sink filtered the message out
+        formatted_key = formatted.size() > 0 ? key : 0;
+    }
+}
+
 SPDLOG_INLINE void logger::flush_() {
     for (auto &sink : sinks_) {
         SPDLOG_TRY { sink->flush(); }
@@ -362,6 +362,12 @@ protected:
     void log_it_(const details::log_msg &log_msg, bool log_enabled, bool traceback_enabled);
     virtual void sink_it_(const details::log_msg &msg);
     virtual void flush_();
+    // log msg to the given sink. sinks with the same format key are given the text
+    // the first of them formatted into formatted (formatted_key is its key).
+    void sink_shared_(sinks::sink &sink,
+                      const details::log_msg &msg,
+                      memory_buf_t &formatted,
+                      uint64_t &formatted_key);
     void dump_backtrace_();
     bool should_flush_(const details::log_msg &msg);
 
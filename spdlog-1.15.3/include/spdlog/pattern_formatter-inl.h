@@ -8,8 +8,11 @@
 #endif
 
 #include <spdlog/details/fmt_helper.h>
+#include <spdlog/details/id_text.h>
 #include <spdlog/details/log_msg.h>
 #include <spdlog/details/os.h>
+#include <spdlog/details/tsc_clock.h>
+#include <spdlog/details/tz_cache.h>
 
 #ifndef SPDLOG_NO_TLS
     #include <spdlog/mdc.h>
@@ -438,6 +441,27 @@ public:
     }
 };
 
+// monotonic nanoseconds since the tsc_clock calibration (SPDLOG_TSC_CLOCK). messages
+// without ticks get their time in the same base, so the values stay comparable.
+template <typename ScopedPadder>
+class Q_formatter final : public flag_formatter {
+public:
+    explicit Q_formatter(padding_info padinfo)
+        : flag_formatter(padinfo) {}
+
+    void format(const details::log_msg &msg, const std::tm &, memory_buf_t &dest) override {
+        const auto &clock = tsc_clock::instance();
+        const int64_t nanos =
+            msg.ticks != 0 ? clock.to_nanos(msg.ticks) : clock.to_nanos(msg.time);
+        // ticks read on another core can be a hair before the calibration point, and times
+        // without ticks can be before it too
+        const auto count = static_cast<uint64_t>((std::max)(nanos, int64_t{0}));
+        auto n_digits = static_cast<size_t>(ScopedPadder::count_digits(count));
+        ScopedPadder p(n_digits, padinfo_, dest);
+        fmt_helper::append_int(count, dest);
+    }
+};
+
 // AM/PM
 template <typename ScopedPadder>
 class p_formatter final : public flag_formatter {
@@ -560,9 +584,15 @@ public:
         : flag_formatter(padinfo) {}
 
     void format(const details::log_msg &msg, const std::tm &, memory_buf_t &dest) override {
+#ifndef SPDLOG_NO_TLS
+        const auto text = thread_id_text(msg.thread_id);
+        ScopedPadder p(text.size(), padinfo_, dest);
+        fmt_helper::append_string_view(text, dest);
+#else
         const auto field_size = ScopedPadder::count_digits(msg.thread_id);
         ScopedPadder p(field_size, padinfo_, dest);
         fmt_helper::append_int(msg.thread_id, dest);
+#endif
     }
 };
 
@@ -574,10 +604,9 @@ public:
         : flag_formatter(padinfo) {}
 
     void format(const details::log_msg &, const std::tm &, memory_buf_t &dest) override {
-        const auto pid = static_cast<uint32_t>(details::os::pid());
-        auto field_size = ScopedPadder::count_digits(pid);
-        ScopedPadder p(field_size, padinfo_, dest);
-        fmt_helper::append_int(pid, dest);
+        const auto text = pid_text::get();
+        ScopedPadder p(text.size(), padinfo_, dest);
+        fmt_helper::append_string_view(text, dest);
     }
 };
 
@@ -612,6 +641,7 @@ public:
     aggregate_formatter() = default;
 
     void add_ch(char ch) { str_ += ch; }
+    const std::string &str() const { return str_; }
     void format(const details::log_msg &, const std::tm &, memory_buf_t &dest) override {
         fmt_helper::append_string_view(str_, dest);
     }
@@ -834,6 +864,140 @@ public:
 };
 #endif
 
+// Run of unpadded date/time flags and the literal text around them,
+// e.g. "[%Y-%m-%d %H:%M:%S.%e".
+// The part that only changes once a second is rendered into a cache and the
+// optional sub second field (%e, %f or %F) is appended to it for each message.
+class datetime_formatter final : public flag_formatter {
+public:
+    datetime_formatter() = default;
+
+    static bool is_cached_flag(char flag) {
+        switch (flag) {
+            case 'Y':
+            case 'C':
+            case 'm':
+            case 'd':
+            case 'H':
+            case 'M':
+            case 'S':
+            case 'D':
+            case 'x':
+            case 'T':
+            case 'X':
+            case 'R':
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    static bool is_fraction_flag(char flag) { return flag == 'e' || flag == 'f' || flag == 'F'; }
+
+    void add_ch(char ch) { spec_.push_back(ch); }
+
+    void add_str(const std::string &str) { spec_ += str; }
+
+    void add_flag(char flag) {
+        spec_.push_back('%');
+        spec_.push_back(flag);
+    }
+
+    void set_fraction(char flag) { fraction_ = flag; }
+
+    void format(const details::log_msg &msg, const std::tm &tm_time, memory_buf_t &dest) override {
+        auto secs =
+            std::chrono::duration_cast<std::chrono::seconds>(msg.time.time_since_epoch());
+        if (cache_timestamp_ != secs || cached_datetime_.size() == 0) {
+            render_(tm_time);
+            cache_timestamp_ = secs;
+        }
+        dest.append(cached_datetime_.begin(), cached_datetime_.end());
+
+        switch (fraction_) {
+            case 'e': {
+                auto millis = fmt_helper::time_fraction<std::chrono::milliseconds>(msg.time);
+                fmt_helper::pad3(static_cast<uint32_t>(millis.count()), dest);
+                break;
+            }
+            case 'f': {
+                auto micros = fmt_helper::time_fraction<std::chrono::microseconds>(msg.time);
+                fmt_helper::pad6(static_cast<size_t>(micros.count()), dest);
+                break;
+            }
+            case 'F': {
+                auto ns = fmt_helper::time_fraction<std::chrono::nanoseconds>(msg.time);
+                fmt_helper::pad9(static_cast<size_t>(ns.count()), dest);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+private:
+    std::string spec_;  // literal chars and "%<flag>" pairs
+    char fraction_ = '\0';
+    std::chrono::seconds cache_timestamp_{0};
+    memory_buf_t cached_datetime_;
+
+    void render_(const std::tm &tm_time) {
+        cached_datetime_.clear();
+        for (size_t i = 0; i < spec_.size(); i++) {
+            if (spec_[i] != '%') {
+                cached_datetime_.push_back(spec_[i]);
+                continue;
+            }
+            switch (spec_[++i]) {
+                case 'Y':
+                    fmt_helper::append_int(tm_time.tm_year + 1900, cached_datetime_);
+                    break;
+                case 'C':
+                    fmt_helper::pad2(tm_time.tm_year % 100, cached_datetime_);
+                    break;
+                case 'm':
+                    fmt_helper::pad2(tm_time.tm_mon + 1, cached_datetime_);
+                    break;
+                case 'd':
+                    fmt_helper::pad2(tm_time.tm_mday, cached_datetime_);
+                    break;
+                case 'H':
+                    fmt_helper::pad2(tm_time.tm_hour, cached_datetime_);
+                    break;
+                case 'M':
+                    fmt_helper::pad2(tm_time.tm_min, cached_datetime_);
+                    break;
+                case 'S':
+                    fmt_helper::pad2(tm_time.tm_sec, cached_datetime_);
+                    break;
+                case 'D':
+                case 'x':
+                    fmt_helper::pad2(tm_time.tm_mon + 1, cached_datetime_);
+                    cached_datetime_.push_back('/');
+                    fmt_helper::pad2(tm_time.tm_mday, cached_datetime_);
+                    cached_datetime_.push_back('/');
+                    fmt_helper::pad2(tm_time.tm_year % 100, cached_datetime_);
+                    break;
+                case 'T':
+                case 'X':
+                    fmt_helper::pad2(tm_time.tm_hour, cached_datetime_);
+                    cached_datetime_.push_back(':');
+                    fmt_helper::pad2(tm_time.tm_min, cached_datetime_);
+                    cached_datetime_.push_back(':');
+                    fmt_helper::pad2(tm_time.tm_sec, cached_datetime_);
+                    break;
+                case 'R':
+                    fmt_helper::pad2(tm_time.tm_hour, cached_datetime_);
+                    cached_datetime_.push_back(':');
+                    fmt_helper::pad2(tm_time.tm_min, cached_datetime_);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+};
+
 // Full info formatter
 // pattern: [%Y-%m-%d %H:%M:%S.%e] [%n] [%l] [%s:%#] %v
 class full_formatter final : public flag_formatter {
@@ -992,6 +1156,33 @@ SPDLOG_INLINE void pattern_formatter::format(const details::log_msg &msg, memory
     details::fmt_helper::append_string_view(eol_, dest);
 }
 
+// custom flags may render anything: patterns using them are only shared if they all have
+// a signature.
+SPDLOG_INLINE std::string pattern_formatter::signature() const {
+    std::string rv = pattern_;
+    rv.push_back('\0');
+    rv.push_back(pattern_time_type_ == pattern_time_type::local ? 'l' : 'u');
+    rv.push_back(need_localtime_ ? '1' : '0');
+    rv += eol_;
+    if (!custom_handlers_.empty()) {
+        std::vector<char> flags;
+        for (auto &it : custom_handlers_) {
+            flags.push_back(it.first);
+        }
+        std::sort(flags.begin(), flags.end());
+        for (char flag : flags) {
+            auto flag_signature = custom_handlers_.at(flag)->signature();
+            if (flag_signature.empty()) {
+                return std::string();
+            }
+            rv.push_back('\0');
+            rv.push_back(flag);
+            rv += flag_signature;
+        }
+    }
+    return rv;
+}
+
 SPDLOG_INLINE void pattern_formatter::set_pattern(std::string pattern) {
     pattern_ = std::move(pattern);
     need_localtime_ = false;
@@ -1002,9 +1193,9 @@ SPDLOG_INLINE void pattern_formatter::need_localtime(bool need) { need_localtime
 
 SPDLOG_INLINE std::tm pattern_formatter::get_time_(const details::log_msg &msg) {
     if (pattern_time_type_ == pattern_time_type::local) {
-        return details::os::localtime(log_clock::to_time_t(msg.time));
+        return details::tz_cache::instance().localtime(log_clock::to_time_t(msg.time));
     }
-    return details::os::gmtime(log_clock::to_time_t(msg.time));
+    return details::tz_cache::instance().gmtime(log_clock::to_time_t(msg.time));
 }
 
 template <typename Padder>
@@ -1134,6 +1325,10 @@ SPDLOG_INLINE void pattern_formatter::handle_flag_(char flag, details::padding_i
             formatters_.push_back(details::make_unique<details::E_formatter<Padder>>(padding));
             break;
 
+        case ('Q'):  // monotonic nanoseconds
+            formatters_.push_back(details::make_unique<details::Q_formatter<Padder>>(padding));
+            break;
+
         case ('p'):  // am/pm
             formatters_.push_back(details::make_unique<details::p_formatter<Padder>>(padding));
             need_localtime_ = true;
@@ -1302,11 +1497,62 @@ SPDLOG_INLINE details::padding_info pattern_formatter::handle_padspec_(
     return details::padding_info{std::min<size_t>(width, max_width), side, truncate};
 }
 
+SPDLOG_INLINE bool pattern_formatter::is_cached_datetime_flag_(char flag) const {
+    return details::datetime_formatter::is_cached_flag(flag) &&
+           custom_handlers_.find(flag) == custom_handlers_.end();
+}
+
+// Collect the run of unpadded date/time flags starting at it (pointing to '%')
+// together with the literal text between and after them, and the sub second
+// flag that may end it.
+// Return iterator to the last char consumed.
+SPDLOG_INLINE std::string::const_iterator pattern_formatter::compile_datetime_run_(
+    std::string::const_iterator it,
+    std::string::const_iterator end,
+    details::datetime_formatter &datetime) {
+    auto last = it;
+    while (it != end) {
+        if (*it != '%') {
+            datetime.add_ch(*it);
+            last = it++;
+            continue;
+        }
+        auto flag_it = it + 1;
+        if (flag_it == end) {
+            break;
+        }
+        if (is_cached_datetime_flag_(*flag_it)) {
+            datetime.add_flag(*flag_it);
+            last = flag_it;
+            it = flag_it + 1;
+        } else if (details::datetime_formatter::is_fraction_flag(*flag_it) &&
+                   custom_handlers_.find(*flag_it) == custom_handlers_.end()) {
+            datetime.set_fraction(*flag_it);
+            last = flag_it;
+            break;
+        } else {
+            break;
+        }
+    }
+    return last;
+}
+
 SPDLOG_INLINE void pattern_formatter::compile_pattern_(const std::string &pattern) {
     auto end = pattern.end();
     std::unique_ptr<details::aggregate_formatter> user_chars;
     formatters_.clear();
     for (auto it = pattern.begin(); it != end; ++it) {
+        if (*it == '%' && it + 1 != end && is_cached_datetime_flag_(*(it + 1))) {
+            auto datetime = details::make_unique<details::datetime_formatter>();
+            if (user_chars) {
+                datetime->add_str(user_chars->str());
+                user_chars.reset();
+            }
+            it = compile_datetime_run_(it, end, *datetime);
+            formatters_.push_back(std::move(datetime));
+            need_localtime_ = true;
+            continue;
+        }
         if (*it == '%') {
             if (user_chars)  // append user chars found so far
             {
@@ -19,6 +19,8 @@
 namespace spdlog {
 namespace details {
 
+class datetime_formatter;
+
 // padding information.
 struct padding_info {
     enum class pad_side { left, right, center };
@@ -57,6 +59,10 @@ class SPDLOG_API custom_flag_formatter : public details::flag_formatter {
 public:
     virtual std::unique_ptr<custom_flag_formatter> clone() const = 0;
 
+    // non empty if the output depends only on the message, equal for flags that render the
+    // same message the same way. lets sinks using the pattern share their formatting.
+    virtual std::string signature() const { return std::string(); }
+
     void set_padding_info(const details::padding_info &padding) {
         flag_formatter::padinfo_ = padding;
     }
@@ -80,6 +86,7 @@ public:
 
     std::unique_ptr<formatter> clone() const override;
     void format(const details::log_msg &msg, memory_buf_t &dest) override;
+    std::string signature() const override;
 
     template <typename T, typename... Args>
     pattern_formatter &add_flag(char flag, Args &&...args) {
@@ -109,6 +116,10 @@ private:
     static details::padding_info handle_padspec_(std::string::const_iterator &it,
                                                  std::string::const_iterator end);
 
+    bool is_cached_datetime_flag_(char flag) const;
+    std::string::const_iterator compile_datetime_run_(std::string::const_iterator it,
+                                                      std::string::const_iterator end,
+                                                      details::datetime_formatter &datetime);
     void compile_pattern_(const std::string &pattern);
 };
 }  // namespace spdlog
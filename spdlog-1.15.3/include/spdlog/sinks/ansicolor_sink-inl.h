@@ -10,6 +10,8 @@
 #include <spdlog/details/os.h>
 #include <spdlog/pattern_formatter.h>
 
+#include <cstring>
+
 namespace spdlog {
 namespace sinks {
 
@@ -28,6 +30,15 @@ SPDLOG_INLINE ansicolor_sink<ConsoleMutex>::ansicolor_sink(FILE *target_file, co
     colors_.at(level::err) = to_string_(red_bold);
     colors_.at(level::critical) = to_string_(bold_on_red);
     colors_.at(level::off) = to_string_(reset);
+    format_key_.store(format_key_of_(formatter_.get()), std::memory_order_relaxed);
+}
+
+template <typename ConsoleMutex>
+SPDLOG_INLINE ansicolor_sink<ConsoleMutex>::~ansicolor_sink() {
+    // no lock: the console mutex may already be gone at exit, and nobody else uses the sink now
+    if (pending_.size() > 0) {
+        write_pending_();
+    }
 }
 
 template <typename ConsoleMutex>
@@ -42,36 +53,97 @@ SPDLOG_INLINE void ansicolor_sink<ConsoleMutex>::log(const details::log_msg &msg
     // Wrap the originally formatted message in color codes.
     // If color is not supported in the terminal, log as is instead.
     std::lock_guard<mutex_t> lock(mutex_);
+    if (filtered_out_(msg)) {
+        return;
+    }
     msg.color_range_start = 0;
     msg.color_range_end = 0;
     memory_buf_t formatted;
     formatter_->format(msg, formatted);
+    print_formatted_(msg, formatted);
+}
+
+template <typename ConsoleMutex>
+SPDLOG_INLINE void ansicolor_sink<ConsoleMutex>::log_and_format(const details::log_msg &msg,
+                                                                memory_buf_t &formatted) {
+    std::lock_guard<mutex_t> lock(mutex_);
+    if (filtered_out_(msg)) {
+        return;  // leaves formatted empty, so the next sink formats for itself
+    }
+    msg.color_range_start = 0;
+    msg.color_range_end = 0;
+    formatter_->format(msg, formatted);
+    print_formatted_(msg, formatted);
+}
+
+template <typename ConsoleMutex>
+SPDLOG_INLINE void ansicolor_sink<ConsoleMutex>::log_formatted(const details::log_msg &msg,
+                                                               const memory_buf_t &formatted) {
+    std::lock_guard<mutex_t> lock(mutex_);
+    if (filtered_out_(msg)) {
+        return;
+    }
+    print_formatted_(msg, formatted);
+}
+
+template <typename ConsoleMutex>
+SPDLOG_INLINE void ansicolor_sink<ConsoleMutex>::print_formatted_(const details::log_msg &msg,
+                                                                  const memory_buf_t &formatted) {
+    if (pending_.size() == 0) {
+        batch_start_ = msg.time;
+    }
     if (should_do_colors_ && msg.color_range_end > msg.color_range_start) {
+        const auto &color = colors_[static_cast<size_t>(msg.level)];
         // before color range
-        print_range_(formatted, 0, msg.color_range_start);
+        append_(formatted.data(), msg.color_range_start);
         // in color range
-        print_ccode_(colors_.at(static_cast<size_t>(msg.level)));
-        print_range_(formatted, msg.color_range_start, msg.color_range_end);
-        print_ccode_(reset);
+        append_(color.data(), color.size());
+        append_(formatted.data() + msg.color_range_start,
+                msg.color_range_end - msg.color_range_start);
+        append_(reset.data(), reset.size());
         // after color range
-        print_range_(formatted, msg.color_range_end, formatted.size());
+        append_(formatted.data() + msg.color_range_end, formatted.size() - msg.color_range_end);
     } else  // no color
     {
-        print_range_(formatted, 0, formatted.size());
+        append_(formatted.data(), formatted.size());
+    }
+    if (pending_.size() >= batch_bytes_ || msg.time - batch_start_ >= batch_delay_) {
+        write_pending_();
     }
-    fflush(target_file_);
 }
 
 template <typename ConsoleMutex>
 SPDLOG_INLINE void ansicolor_sink<ConsoleMutex>::flush() {
     std::lock_guard<mutex_t> lock(mutex_);
-    fflush(target_file_);
+    write_pending_();
+}
+
+template <typename ConsoleMutex>
+SPDLOG_INLINE void ansicolor_sink<ConsoleMutex>::set_batching(size_t max_bytes,
+                                                              std::chrono::milliseconds max_delay) {
+    std::lock_guard<mutex_t> lock(mutex_);
+    write_pending_();
+    batch_bytes_ = max_bytes;
+    batch_delay_ = std::chrono::duration_cast<log_clock::duration>(max_delay);
+}
+
+template <typename ConsoleMutex>
+SPDLOG_INLINE void ansicolor_sink<ConsoleMutex>::set_filter(sink_filter filter) {
+    std::lock_guard<mutex_t> lock(mutex_);
+    filter_ = details::make_unique<sink_filter>(std::move(filter));
+}
+
+template <typename ConsoleMutex>
+SPDLOG_INLINE void ansicolor_sink<ConsoleMutex>::remove_filter() {
+    std::lock_guard<mutex_t> lock(mutex_);
+    filter_.reset();
 }
 
 template <typename ConsoleMutex>
 SPDLOG_INLINE void ansicolor_sink<ConsoleMutex>::set_pattern(const std::string &pattern) {
     std::lock_guard<mutex_t> lock(mutex_);
     formatter_ = std::unique_ptr<spdlog::formatter>(new pattern_formatter(pattern));
+    format_key_.store(format_key_of_(formatter_.get()), std::memory_order_relaxed);
 }
 
 template <typename ConsoleMutex>
@@ -79,6 +151,7 @@ SPDLOG_INLINE void ansicolor_sink<ConsoleMutex>::set_formatter(
     std::unique_ptr<spdlog::formatter> sink_formatter) {
     std::lock_guard<mutex_t> lock(mutex_);
     formatter_ = std::move(sink_formatter);
+    format_key_.store(format_key_of_(formatter_.get()), std::memory_order_relaxed);
 }
 
 template <typename ConsoleMutex>
@@ -111,16 +184,26 @@ SPDLOG_INLINE void ansicolor_sink<ConsoleMutex>::set_color_mode_(color_mode mode
 }
 
 template <typename ConsoleMutex>
-SPDLOG_INLINE void ansicolor_sink<ConsoleMutex>::print_ccode_(
-    const string_view_t &color_code) const {
-    details::os::fwrite_bytes(color_code.data(), color_code.size(), target_file_);
+SPDLOG_INLINE bool ansicolor_sink<ConsoleMutex>::filtered_out_(const details::log_msg &msg) const {
+    return filter_ != nullptr && !filter_->should_log(msg);
 }
 
 template <typename ConsoleMutex>
-SPDLOG_INLINE void ansicolor_sink<ConsoleMutex>::print_range_(const memory_buf_t &formatted,
-                                                              size_t start,
-                                                              size_t end) const {
-    details::os::fwrite_bytes(formatted.data() + start, end - start, target_file_);
+SPDLOG_INLINE void ansicolor_sink<ConsoleMutex>::append_(const char *data, size_t size) {
+    // resize + memcpy: buffer::append() copies byte by byte
+    const auto old_size = pending_.size();
+    pending_.resize(old_size + size);
+    std::memcpy(pending_.data() + old_size, data, size);
+}
+
+// one fwrite and one fflush: a single write() on the console, also for the unbuffered stderr
+template <typename ConsoleMutex>
+SPDLOG_INLINE void ansicolor_sink<ConsoleMutex>::write_pending_() {
+    if (pending_.size() > 0) {
+        details::os::fwrite_bytes(pending_.data(), pending_.size(), target_file_);
+        pending_.clear();
+    }
+    fflush(target_file_);
 }
 
 template <typename ConsoleMutex>
@@ -4,11 +4,13 @@
 #pragma once
 
 #include <array>
+#include <chrono>
 #include <memory>
 #include <mutex>
 #include <spdlog/details/console_globals.h>
 #include <spdlog/details/null_mutex.h>
 #include <spdlog/sinks/sink.h>
+#include <spdlog/sinks/sink_filter.h>
 #include <string>
 
 namespace spdlog {
@@ -19,6 +21,8 @@ namespace sinks {
  * depending on the severity
  * of the message.
  * If no color terminal detected, omit the escape codes.
+ * Each message is assembled with its color codes in one buffer and written at once.
+ * With set_batching(), messages are collected and written together instead.
  */
 
 template <typename ConsoleMutex>
@@ -26,7 +30,7 @@ class ansicolor_sink : public sink {
 public:
     using mutex_t = typename ConsoleMutex::mutex_t;
     ansicolor_sink(FILE *target_file, color_mode mode);
-    ~ansicolor_sink() override = default;
+    ~ansicolor_sink() override;
 
     ansicolor_sink(const ansicolor_sink &other) = delete;
     ansicolor_sink(ansicolor_sink &&other) = delete;
@@ -38,7 +42,19 @@ public:
     void set_color_mode(color_mode mode);
     bool should_color() const;
 
+    // collect the output of several messages and write it with a single write,
+    // once max_bytes are pending or the oldest pending message is max_delay old.
+    // pending output is also written by flush() and on destruction; with little
+    // logging use spdlog::flush_every() to bound the delay. 0 max_bytes: write each message.
+    void set_batching(size_t max_bytes, std::chrono::milliseconds max_delay);
+
+    // messages the filter drops are never formatted
+    void set_filter(sink_filter filter);
+    void remove_filter();
+
     void log(const details::log_msg &msg) override;
+    void log_and_format(const details::log_msg &msg, memory_buf_t &formatted) override;
+    void log_formatted(const details::log_msg &msg, const memory_buf_t &formatted) override;
     void flush() override;
     void set_pattern(const std::string &pattern) final override;
     void set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) override;
@@ -83,10 +99,17 @@ private:
     mutex_t &mutex_;
     bool should_do_colors_;
     std::unique_ptr<spdlog::formatter> formatter_;
+    std::unique_ptr<sink_filter> filter_;
     std::array<std::string, level::n_levels> colors_;
+    memory_buf_t pending_;  // output not written yet
+    size_t batch_bytes_ = 0;
+    log_clock::duration batch_delay_{};
+    log_clock::time_point batch_start_;
     void set_color_mode_(color_mode mode);
-    void print_ccode_(const string_view_t &color_code) const;
-    void print_range_(const memory_buf_t &formatted, size_t start, size_t end) const;
+    bool filtered_out_(const details::log_msg &msg) const;
+    void print_formatted_(const details::log_msg &msg, const memory_buf_t &formatted);
+    void append_(const char *data, size_t size);
+    void write_pending_();
     static std::string to_string_(const string_view_t &sv);
 };
 
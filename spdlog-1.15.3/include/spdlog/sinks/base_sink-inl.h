@@ -25,9 +25,41 @@ SPDLOG_INLINE spdlog::sinks::base_sink<Mutex>::base_sink(
 template <typename Mutex>
 void SPDLOG_INLINE spdlog::sinks::base_sink<Mutex>::log(const details::log_msg &msg) {
     std::lock_guard<Mutex> lock(mutex_);
+    if (filtered_out_(msg)) {
+        return;
+    }
     sink_it_(msg);
 }
 
+template <typename Mutex>
+void SPDLOG_INLINE spdlog::sinks::base_sink<Mutex>::log_and_format(const details::log_msg &msg,
+                                                                   memory_buf_t &formatted) {
+    std::lock_guard<Mutex> lock(mutex_);
+    if (filtered_out_(msg)) {
+        return;  // leaves formatted empty, so the next sink formats for itself
+    }
+    if (!format_sharing_) {
+        sink_it_(msg);
+        return;
+    }
+    formatter_->format(msg, formatted);
+    sink_formatted_(msg, formatted);
+}
+
+template <typename Mutex>
+void SPDLOG_INLINE spdlog::sinks::base_sink<Mutex>::log_formatted(const details::log_msg &msg,
+                                                                  const memory_buf_t &formatted) {
+    std::lock_guard<Mutex> lock(mutex_);
+    if (filtered_out_(msg)) {
+        return;
+    }
+    if (!format_sharing_) {
+        sink_it_(msg);
+        return;
+    }
+    sink_formatted_(msg, formatted);
+}
+
 template <typename Mutex>
 void SPDLOG_INLINE spdlog::sinks::base_sink<Mutex>::flush() {
     std::lock_guard<Mutex> lock(mutex_);
@@ -38,6 +70,7 @@ template <typename Mutex>
 void SPDLOG_INLINE spdlog::sinks::base_sink<Mutex>::set_pattern(const std::string &pattern) {
     std::lock_guard<Mutex> lock(mutex_);
     set_pattern_(pattern);
+    update_format_key_();
 }
 
 template <typename Mutex>
@@ -45,6 +78,19 @@ void SPDLOG_INLINE
 spdlog::sinks::base_sink<Mutex>::set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) {
     std::lock_guard<Mutex> lock(mutex_);
     set_formatter_(std::move(sink_formatter));
+    update_format_key_();
+}
+
+template <typename Mutex>
+void SPDLOG_INLINE spdlog::sinks::base_sink<Mutex>::set_filter(sink_filter filter) {
+    std::lock_guard<Mutex> lock(mutex_);
+    filter_ = details::make_unique<sink_filter>(std::move(filter));
+}
+
+template <typename Mutex>
+void SPDLOG_INLINE spdlog::sinks::base_sink<Mutex>::remove_filter() {
+    std::lock_guard<Mutex> lock(mutex_);
+    filter_.reset();
 }
 
 template <typename Mutex>
@@ -57,3 +103,28 @@ void SPDLOG_INLINE
 spdlog::sinks::base_sink<Mutex>::set_formatter_(std::unique_ptr<spdlog::formatter> sink_formatter) {
     formatter_ = std::move(sink_formatter);
 }
+
+template <typename Mutex>
+void SPDLOG_INLINE spdlog::sinks::base_sink<Mutex>::sink_formatted_(const details::log_msg &msg,
+                                                                    const memory_buf_t &) {
+    sink_it_(msg);
+}
+
+template <typename Mutex>
+void SPDLOG_INLINE spdlog::sinks::base_sink<Mutex>::enable_format_sharing_() {
+    format_sharing_ = true;
+    update_format_key_();
+}
+
+template <typename Mutex>
+void SPDLOG_INLINE spdlog::sinks::base_sink<Mutex>::update_format_key_() {
+    if (format_sharing_) {
+        format_key_.store(format_key_of_(formatter_.get()), std::memory_order_relaxed);
+    }
+}
+
+template <typename Mutex>
+bool SPDLOG_INLINE
+spdlog::sinks::base_sink<Mutex>::filtered_out_(const details::log_msg &msg) const {
+    return filter_ != nullptr && !filter_->should_log(msg);
+}
@@ -12,6 +12,7 @@
 #include <spdlog/common.h>
 #include <spdlog/details/log_msg.h>
 #include <spdlog/sinks/sink.h>
+#include <spdlog/sinks/sink_filter.h>
 
 namespace spdlog {
 namespace sinks {
@@ -29,10 +30,16 @@ public:
     base_sink &operator=(base_sink &&) = delete;
 
     void log(const details::log_msg &msg) final override;
+    void log_and_format(const details::log_msg &msg, memory_buf_t &formatted) final override;
+    void log_formatted(const details::log_msg &msg, const memory_buf_t &formatted) final override;
     void flush() final override;
     void set_pattern(const std::string &pattern) final override;
     void set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) final override;
 
+    // messages the filter drops are never formatted
+    void set_filter(sink_filter filter);
+    void remove_filter();
+
 protected:
     // sink formatter
     std::unique_ptr<spdlog::formatter> formatter_;
@@ -42,6 +49,18 @@ protected:
     virtual void flush_() = 0;
     virtual void set_pattern_(const std::string &pattern);
     virtual void set_formatter_(std::unique_ptr<spdlog::formatter> sink_formatter);
+
+    // Sinks that write formatter_'s output as is can take a message formatted
+    // by another sink with an equal formatter: they override sink_formatted_()
+    // and call enable_format_sharing_() from their constructor.
+    virtual void sink_formatted_(const details::log_msg &msg, const memory_buf_t &formatted);
+    void enable_format_sharing_();
+
+private:
+    std::unique_ptr<sink_filter> filter_;
+    bool format_sharing_ = false;
+    bool filtered_out_(const details::log_msg &msg) const;
+    void update_format_key_();
 };
 }  // namespace sinks
 }  // namespace spdlog
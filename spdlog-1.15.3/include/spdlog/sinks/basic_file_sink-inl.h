@@ -19,6 +19,7 @@ SPDLOG_INLINE basic_file_sink<Mutex>::basic_file_sink(const filename_t &filename
                                                       const file_event_handlers &event_handlers)
     : file_helper_{event_handlers} {
     file_helper_.open(filename, truncate);
+    base_sink<Mutex>::enable_format_sharing_();
 }
 
 template <typename Mutex>
@@ -39,6 +40,12 @@ SPDLOG_INLINE void basic_file_sink<Mutex>::sink_it_(const details::log_msg &msg)
     file_helper_.write(formatted);
 }
 
+template <typename Mutex>
+SPDLOG_INLINE void basic_file_sink<Mutex>::sink_formatted_(const details::log_msg &,
+                                                           const memory_buf_t &formatted) {
+    file_helper_.write(formatted);
+}
+
 template <typename Mutex>
 SPDLOG_INLINE void basic_file_sink<Mutex>::flush_() {
     file_helper_.flush();
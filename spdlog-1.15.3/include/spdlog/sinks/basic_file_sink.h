@@ -27,6 +27,7 @@ public:
 
 protected:
     void sink_it_(const details::log_msg &msg) override;
+    void sink_formatted_(const details::log_msg &msg, const memory_buf_t &formatted) override;
     void flush_() override;
 
 private:
@@ -0,0 +1,124 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#ifndef SPDLOG_HEADER_ONLY
+    #include <spdlog/sinks/binary_file_sink.h>
+#endif
+
+#include <spdlog/common.h>
+#include <spdlog/details/binary_log.h>
+#include <spdlog/details/os.h>
+
+namespace spdlog {
+namespace sinks {
+
+template <typename Mutex>
+SPDLOG_INLINE binary_file_sink<Mutex>::binary_file_sink(const filename_t &filename,
+                                                        bool truncate,
+                                                        size_t sync_interval,
+                                                        const file_event_handlers &event_handlers)
+    : file_helper_{event_handlers},
+      sync_interval_(sync_interval),
+      block_size_(sync_interval) {
+    file_helper_.open(filename, truncate);
+    write_header_();
+}
+
+template <typename Mutex>
+SPDLOG_INLINE const filename_t &binary_file_sink<Mutex>::filename() const {
+    return file_helper_.filename();
+}
+
+template <typename Mutex>
+SPDLOG_INLINE void binary_file_sink<Mutex>::truncate() {
+    std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+    file_helper_.reopen(true);
+    write_header_();
+}
+
+template <typename Mutex>
+SPDLOG_INLINE void binary_file_sink<Mutex>::sink_it_(const details::log_msg &msg) {
+    using namespace details::binary_log;
+
+    buf_.clear();
+    const auto time_ns = to_nanos(msg.time);
+    if (block_size_ >= sync_interval_) {
+        start_block_(time_ns);
+    }
+
+    // string definitions go to buf_ ahead of the record that uses them
+    const auto logger_id = string_id_(msg.logger_name);
+    uint64_t file_id = 0;
+    uint64_t func_id = 0;
+    if (!msg.source.empty()) {
+        file_id = string_id_(msg.source.filename);
+        if (msg.source.funcname != nullptr) {
+            func_id = string_id_(msg.source.funcname);
+        }
+    }
+
+    buf_.push_back(static_cast<char>(tag_message));
+    write_varint(zigzag(time_ns - last_time_), buf_);
+    buf_.push_back(static_cast<char>(msg.level));
+    write_varint(logger_id, buf_);
+    write_varint(msg.thread_id, buf_);
+    write_varint(file_id, buf_);
+    write_varint(file_id != 0 ? static_cast<uint64_t>(msg.source.line) : 0, buf_);
+    write_varint(func_id, buf_);
+    write_bytes(msg.payload, buf_);
+    last_time_ = time_ns;
+
+    file_helper_.write(buf_);
+    block_size_ += buf_.size();
+}
+
+template <typename Mutex>
+SPDLOG_INLINE void binary_file_sink<Mutex>::flush_() {
+    file_helper_.flush();
+}
+
+// every open starts with a header, so appending to an existing file (or to one
+// written by another process) keeps it decodable.
+template <typename Mutex>
+SPDLOG_INLINE void binary_file_sink<Mutex>::write_header_() {
+    buf_.clear();
+    details::binary_log::write_header(buf_);
+    file_helper_.write(buf_);
+    block_size_ = sync_interval_;  // sync before the next record
+}
+
+template <typename Mutex>
+SPDLOG_INLINE void binary_file_sink<Mutex>::start_block_(int64_t time_ns) {
+    details::binary_log::write_sync(time_ns, buf_);
+    strings_.clear();
+    next_id_ = 1;
+    last_time_ = time_ns;
+    block_size_ = 0;
+}
+
+template <typename Mutex>
+SPDLOG_INLINE uint64_t binary_file_sink<Mutex>::string_id_(string_view_t str) {
+    // FNV-1a, so looking up doesn't allocate a std::string key
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < str.size(); i++) {
+        hash = (hash ^ static_cast<unsigned char>(str.data()[i])) * 1099511628211ULL;
+    }
+    auto it = strings_.find(hash);
+    if (it != strings_.end() && string_view_t(it->second.text) == str) {
+        return it->second.id;
+    }
+
+    const auto id = next_id_++;
+    buf_.push_back(static_cast<char>(details::binary_log::tag_string));
+    details::binary_log::write_varint(id, buf_);
+    details::binary_log::write_bytes(str, buf_);
+    if (it == strings_.end()) {
+        strings_.emplace(hash, string_entry{std::string(str.data(), str.size()), id});
+    }
+    return id;
+}
+
+}  // namespace sinks
+}  // namespace spdlog
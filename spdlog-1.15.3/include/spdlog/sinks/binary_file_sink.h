@@ -0,0 +1,89 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <spdlog/details/file_helper.h>
+#include <spdlog/details/null_mutex.h>
+#include <spdlog/details/synchronous_factory.h>
+#include <spdlog/sinks/base_sink.h>
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace spdlog {
+namespace sinks {
+/*
+ * File sink writing the compact binary format described in details/binary_log.h.
+ * Logger names and source locations are written once per block and referred to
+ * by id, timestamps are stored as varint deltas. The formatter is not used:
+ * messages are turned back into text with the spdlog-decode tool.
+ */
+template <typename Mutex>
+class binary_file_sink final : public base_sink<Mutex> {
+public:
+    static constexpr size_t default_sync_interval = 64 * 1024;
+
+    // sync_interval: bytes written between sync markers, i.e. the most that is
+    // lost when a block is damaged.
+    explicit binary_file_sink(const filename_t &filename,
+                              bool truncate = false,
+                              size_t sync_interval = default_sync_interval,
+                              const file_event_handlers &event_handlers = {});
+    const filename_t &filename() const;
+    void truncate();
+
+protected:
+    void sink_it_(const details::log_msg &msg) override;
+    void flush_() override;
+
+private:
+    struct string_entry {
+        std::string text;
+        uint64_t id;
+    };
+
+    details::file_helper file_helper_;
+    size_t sync_interval_;
+    size_t block_size_;
+    int64_t last_time_ = 0;
+    memory_buf_t buf_;
+
+    // strings defined in the current block, by hash
+    std::unordered_map<uint64_t, string_entry> strings_;
+    uint64_t next_id_ = 1;
+
+    void write_header_();
+    void start_block_(int64_t time_ns);
+    uint64_t string_id_(string_view_t str);
+};
+
+using binary_file_sink_mt = binary_file_sink<std::mutex>;
+using binary_file_sink_st = binary_file_sink<details::null_mutex>;
+
+}  // namespace sinks
+
+//
+// factory functions
+//
+template <typename Factory = spdlog::synchronous_factory>
+inline std::shared_ptr<logger> binary_logger_mt(const std::string &logger_name,
+                                                const filename_t &filename,
+                                                bool truncate = false) {
+    return Factory::template create<sinks::binary_file_sink_mt>(logger_name, filename, truncate);
+}
+
+template <typename Factory = spdlog::synchronous_factory>
+inline std::shared_ptr<logger> binary_logger_st(const std::string &logger_name,
+                                                const filename_t &filename,
+                                                bool truncate = false) {
+    return Factory::template create<sinks::binary_file_sink_st>(logger_name, filename, truncate);
+}
+
+}  // namespace spdlog
+
+#ifdef SPDLOG_HEADER_ONLY
+    #include "binary_file_sink-inl.h"
+#endif
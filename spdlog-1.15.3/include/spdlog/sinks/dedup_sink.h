@@ -0,0 +1,209 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include "dist_sink.h"
+#include <spdlog/details/log_msg.h>
+#include <spdlog/details/null_mutex.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Duplicate message removal sink, across interleaved messages.
+// Remembers the recently seen messages (logger, level and payload) in a small
+// hash table. A message seen again within "window" of its first occurrence is
+// skipped and counted; once the window is over a summary is logged instead:
+//
+//     #include <spdlog/sinks/dedup_sink.h>
+//
+//     auto dedup = std::make_shared<spdlog::sinks::dedup_sink_mt>(std::chrono::seconds(5));
+//     dedup->add_sink(std::make_shared<spdlog::sinks::stdout_color_sink_mt>());
+//     spdlog::logger l("logger", dedup);
+//     for (int i = 0; i < 3; i++) {
+//         l.error("disk full");
+//         l.warn("retrying");
+//     }
+//
+// Will produce (the summaries after 5 seconds, with the next logged message):
+//       [2019-06-25 17:50:56.511] [logger] [error] disk full
+//       [2019-06-25 17:50:56.511] [logger] [warning] retrying
+//       [2019-06-25 17:51:01.620] [logger] [error] message repeated 2 times: disk full
+//       [2019-06-25 17:51:01.620] [logger] [warning] message repeated 2 times: retrying
+//       ...
+//
+// Summaries are written when the message shows up again after its window, when
+// its entry is evicted from the table, or by an incremental sweep that checks
+// one entry per logged message. flush() and the destructor write all the pending
+// summaries. Each message costs one hash and a few probes.
+
+namespace spdlog {
+namespace sinks {
+template <typename Mutex>
+class dedup_sink : public dist_sink<Mutex> {
+public:
+    // table_size: number of distinct messages remembered, rounded up to a power of 2
+    template <class Rep, class Period>
+    explicit dedup_sink(std::chrono::duration<Rep, Period> window, size_t table_size = 256)
+        : window_{std::chrono::duration_cast<log_clock::duration>(window)} {
+        size_t size = 8;
+        while (size < table_size) {
+            size <<= 1;
+        }
+        table_.resize(size);
+    }
+
+    ~dedup_sink() override {
+        SPDLOG_TRY {
+            std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+            log_pending_summaries_(log_clock::now());
+        }
+        SPDLOG_CATCH_STD
+    }
+
+protected:
+    struct entry {
+        uint64_t hash = 0;
+        bool used = false;
+        level::level_enum level = level::off;
+        log_clock::time_point window_start;
+        size_t repeats = 0;
+        std::string logger_name;
+        std::string payload;
+    };
+
+    static constexpr size_t max_probes = 8;
+
+    log_clock::duration window_;
+    std::vector<entry> table_;
+    size_t sweep_pos_ = 0;
+
+    void sink_it_(const details::log_msg &msg) override {
+        sweep_(msg.time);
+
+        const auto hash = hash_(msg);
+        const size_t mask = table_.size() - 1;
+        entry *victim = nullptr;
+        for (size_t i = 0; i < max_probes; i++) {
+            entry &e = table_[(hash + i) & mask];
+            if (!e.used) {
+                victim = victim != nullptr ? victim : &e;
+                continue;
+            }
+            if (e.hash == hash && same_(e, msg)) {
+                if (msg.time - e.window_start <= window_) {
+                    e.repeats++;
+                    return;
+                }
+                log_summary_(e, msg.time);
+                e.window_start = msg.time;
+                dist_sink<Mutex>::sink_it_(msg);
+                return;
+            }
+            if (victim == nullptr || (victim->used && e.window_start < victim->window_start)) {
+                victim = &e;
+            }
+        }
+
+        if (victim->used) {
+            log_summary_(*victim, msg.time);
+        }
+        victim->used = true;
+        victim->hash = hash;
+        victim->level = msg.level;
+        victim->window_start = msg.time;
+        victim->repeats = 0;
+        victim->logger_name.assign(msg.logger_name.data(), msg.logger_name.size());
+        victim->payload.assign(msg.payload.data(), msg.payload.size());
+        dist_sink<Mutex>::sink_it_(msg);
+    }
+
+    // write the held back summaries before flushing: with no more logging they
+    // would otherwise wait for the next message. the entries stay, so repeats
+    // within their window are still counted.
+    void flush_() override {
+        log_pending_summaries_(log_clock::now());
+        dist_sink<Mutex>::flush_();
+    }
+
+    void log_pending_summaries_(log_clock::time_point now) {
+        for (auto &e : table_) {
+            if (e.used) {
+                log_summary_(e, now);
+            }
+        }
+    }
+
+    // check one entry per message, so summaries of messages that stopped
+    // repeating aren't held back until the entry gets reused.
+    void sweep_(log_clock::time_point now) {
+        entry &e = table_[sweep_pos_];
+        sweep_pos_ = (sweep_pos_ + 1) & (table_.size() - 1);
+        if (e.used && e.repeats > 0 && now - e.window_start > window_) {
+            log_summary_(e, now);
+            e.used = false;
+        }
+    }
+
+    void log_summary_(entry &e, log_clock::time_point now) {
+        if (e.repeats == 0) {
+            return;
+        }
+        memory_buf_t buf;
+        char prefix[64];
+        auto prefix_size = ::snprintf(prefix, sizeof(prefix), "message repeated %u times: ",
+                                      static_cast<unsigned>(e.repeats));
+        if (prefix_size > 0 && static_cast<size_t>(prefix_size) < sizeof(prefix)) {
+            buf.append(prefix, prefix + prefix_size);
+            buf.append(e.payload.data(), e.payload.data() + e.payload.size());
+            details::log_msg summary{now, source_loc{}, e.logger_name, e.level,
+                                     string_view_t{buf.data(), buf.size()}};
+            dist_sink<Mutex>::sink_it_(summary);
+        }
+        e.repeats = 0;
+    }
+
+    static bool same_(const entry &e, const details::log_msg &msg) {
+        return e.level == msg.level && string_view_t(e.payload) == msg.payload &&
+               string_view_t(e.logger_name) == msg.logger_name;
+    }
+
+    // 64 bit hash of logger, level and payload, 8 bytes at a time
+    static uint64_t hash_(const details::log_msg &msg) {
+        uint64_t h = 0x9e3779b97f4a7c15ULL ^ static_cast<uint64_t>(msg.level);
+        h = mix_(h, msg.logger_name);
+        h = mix_(h, msg.payload);
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    static uint64_t mix_(uint64_t h, string_view_t str) {
+        const char *p = str.data();
+        size_t n = str.size();
+        for (; n >= 8; p += 8, n -= 8) {
+            uint64_t word;
+            std::memcpy(&word, p, 8);
+            h = (h ^ (word * 0x87c37b91114253d5ULL)) * 0x4cf5ad432745937fULL;
+            h = (h << 31) | (h >> 33);
+        }
+        uint64_t tail = static_cast<uint64_t>(str.size()) << 56;
+        for (size_t i = 0; i < n; i++) {
+            tail |= static_cast<uint64_t>(static_cast<unsigned char>(p[i])) << (i * 8);
+        }
+        h = (h ^ (tail * 0x87c37b91114253d5ULL)) * 0x4cf5ad432745937fULL;
+        return (h << 31) | (h >> 33);
+    }
+};
+
+using dedup_sink_mt = dedup_sink<std::mutex>;
+using dedup_sink_st = dedup_sink<details::null_mutex>;
+
+}  // namespace sinks
+}  // namespace spdlog
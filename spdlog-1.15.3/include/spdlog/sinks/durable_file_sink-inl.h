@@ -0,0 +1,133 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#ifndef SPDLOG_HEADER_ONLY
+    #include <spdlog/sinks/durable_file_sink.h>
+#endif
+
+#include <spdlog/common.h>
+#include <spdlog/details/os.h>
+
+namespace spdlog {
+namespace sinks {
+
+template <typename Mutex>
+SPDLOG_INLINE durable_file_sink<Mutex>::durable_file_sink(const filename_t &filename,
+                                                          bool truncate,
+                                                          size_t preallocate_size,
+                                                          const file_event_handlers &event_handlers)
+    : file_helper_{event_handlers},
+      preallocate_size_(preallocate_size) {
+    file_helper_.open(filename, truncate);
+    file_size_ = file_helper_.size();
+    reserved_end_ = file_size_;
+    base_sink<Mutex>::enable_format_sharing_();
+}
+
+template <typename Mutex>
+SPDLOG_INLINE const filename_t &durable_file_sink<Mutex>::filename() const {
+    return file_helper_.filename();
+}
+
+template <typename Mutex>
+SPDLOG_INLINE uint64_t durable_file_sink<Mutex>::last_sequence() const {
+    return last_seq_.load(std::memory_order_acquire);
+}
+
+template <typename Mutex>
+SPDLOG_INLINE uint64_t durable_file_sink<Mutex>::durable_sequence() const {
+    return durable_seq_.load(std::memory_order_acquire);
+}
+
+template <typename Mutex>
+SPDLOG_INLINE void durable_file_sink<Mutex>::wait_durable(uint64_t seq) {
+    if (durable_sequence() >= seq) {
+        return;
+    }
+    {
+        std::unique_lock<std::mutex> lock(sync_mutex_);
+        while (syncing_ && durable_sequence() < seq) {
+            sync_cv_.wait(lock);
+        }
+        if (durable_sequence() >= seq) {
+            return;
+        }
+        syncing_ = true;
+    }
+
+    // lead the sync for all the messages written so far. the waiting threads
+    // are released even if it throws, one of them retries.
+    struct sync_leader {
+        durable_file_sink &sink;
+        uint64_t synced;
+        ~sync_leader() { sink.set_durable_(synced); }
+    } leader{*this, 0};
+
+    uint64_t target;
+    {
+        std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+        file_helper_.flush();
+        target = last_seq_.load(std::memory_order_relaxed);
+    }
+    file_helper_.datasync();  // without the sink lock: logging goes on meanwhile
+    leader.synced = target;
+}
+
+template <typename Mutex>
+SPDLOG_INLINE void durable_file_sink<Mutex>::sync() {
+    wait_durable(last_sequence());
+}
+
+template <typename Mutex>
+SPDLOG_INLINE void durable_file_sink<Mutex>::sink_it_(const details::log_msg &msg) {
+    memory_buf_t formatted;
+    base_sink<Mutex>::formatter_->format(msg, formatted);
+    sink_formatted_(msg, formatted);
+}
+
+template <typename Mutex>
+SPDLOG_INLINE void durable_file_sink<Mutex>::sink_formatted_(const details::log_msg &,
+                                                             const memory_buf_t &formatted) {
+    const size_t new_size = file_size_ + formatted.size();
+    if (new_size > reserved_end_ && preallocate_size_ > 0) {
+        const size_t start = reserved_end_;
+        while (reserved_end_ < new_size) {
+            reserved_end_ += preallocate_size_;
+        }
+        file_helper_.preallocate(start, reserved_end_ - start);
+    }
+    file_helper_.write(formatted);
+    file_size_ = new_size;
+    last_seq_.store(last_seq_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+template <typename Mutex>
+SPDLOG_INLINE void durable_file_sink<Mutex>::flush_() {
+    file_helper_.flush();
+    file_helper_.datasync();
+    {
+        std::lock_guard<std::mutex> lock(sync_mutex_);
+        if (last_sequence() > durable_sequence()) {
+            durable_seq_.store(last_sequence(), std::memory_order_release);
+        }
+    }
+    sync_cv_.notify_all();
+}
+
+// end of a wait_durable() sync (synced is 0 if it failed)
+template <typename Mutex>
+SPDLOG_INLINE void durable_file_sink<Mutex>::set_durable_(uint64_t synced) {
+    {
+        std::lock_guard<std::mutex> lock(sync_mutex_);
+        syncing_ = false;
+        if (synced > durable_sequence()) {
+            durable_seq_.store(synced, std::memory_order_release);
+        }
+    }
+    sync_cv_.notify_all();
+}
+
+}  // namespace sinks
+}  // namespace spdlog
@@ -0,0 +1,105 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <spdlog/details/file_helper.h>
+#include <spdlog/details/null_mutex.h>
+#include <spdlog/details/synchronous_factory.h>
+#include <spdlog/sinks/base_sink.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+namespace spdlog {
+namespace sinks {
+/*
+ * File sink for logs that must reach the disk, e.g. audit trails.
+ *
+ * Messages are numbered from 1 in the order they are written. wait_durable(n)
+ * returns once messages up to n are on disk: the first waiting thread flushes
+ * and fdatasync()s everything written so far, threads arriving meanwhile wait
+ * for that sync or share the next one (group commit), and the sink keeps
+ * accepting messages while the disk works.
+ *
+ *     auto sink = std::make_shared<spdlog::sinks::durable_file_sink_mt>("logs/audit.txt");
+ *     spdlog::logger audit("audit", sink);
+ *     audit.info("transfer {} approved", id);
+ *     sink->sync();  // or wait_durable(sink->last_sequence()) from any thread
+ *
+ * Disk space is reserved ahead in chunks of preallocate_size with
+ * fallocate(FALLOC_FL_KEEP_SIZE) on Linux, so appends don't allocate blocks
+ * and a sync mostly writes data; the unused reservation is given back on close.
+ * flush() is durable too, but holds the sink lock during the fdatasync.
+ */
+template <typename Mutex>
+class durable_file_sink final : public base_sink<Mutex> {
+public:
+    static constexpr size_t default_preallocate_size = 16 * 1024 * 1024;
+
+    // preallocate_size: 0 to grow the file as usual
+    explicit durable_file_sink(const filename_t &filename,
+                               bool truncate = false,
+                               size_t preallocate_size = default_preallocate_size,
+                               const file_event_handlers &event_handlers = {});
+    const filename_t &filename() const;
+
+    // number of the last message written
+    uint64_t last_sequence() const;
+    // messages up to this number are on disk
+    uint64_t durable_sequence() const;
+    // block until message seq is on disk. if seq wasn't written yet, return after one sync.
+    void wait_durable(uint64_t seq);
+    // wait until everything written so far is on disk
+    void sync();
+
+protected:
+    void sink_it_(const details::log_msg &msg) override;
+    void sink_formatted_(const details::log_msg &msg, const memory_buf_t &formatted) override;
+    void flush_() override;
+
+private:
+    details::file_helper file_helper_;
+    size_t preallocate_size_;
+    size_t file_size_;
+    size_t reserved_end_;
+    std::atomic<uint64_t> last_seq_{0};
+    std::atomic<uint64_t> durable_seq_{0};
+
+    std::mutex sync_mutex_;
+    std::condition_variable sync_cv_;
+    bool syncing_ = false;
+
+    void set_durable_(uint64_t seq);
+};
+
+using durable_file_sink_mt = durable_file_sink<std::mutex>;
+using durable_file_sink_st = durable_file_sink<details::null_mutex>;
+
+}  // namespace sinks
+
+//
+// factory functions
+//
+template <typename Factory = spdlog::synchronous_factory>
+inline std::shared_ptr<logger> durable_logger_mt(const std::string &logger_name,
+                                                 const filename_t &filename,
+                                                 bool truncate = false) {
+    return Factory::template create<sinks::durable_file_sink_mt>(logger_name, filename, truncate);
+}
+
+template <typename Factory = spdlog::synchronous_factory>
+inline std::shared_ptr<logger> durable_logger_st(const std::string &logger_name,
+                                                 const filename_t &filename,
+                                                 bool truncate = false) {
+    return Factory::template create<sinks::durable_file_sink_st>(logger_name, filename, truncate);
+}
+
+}  // namespace spdlog
+
+#ifdef SPDLOG_HEADER_ONLY
+    #include "durable_file_sink-inl.h"
+#endif
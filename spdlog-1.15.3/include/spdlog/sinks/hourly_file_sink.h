@@ -9,6 +9,7 @@
 #include <spdlog/details/null_mutex.h>
 #include <spdlog/details/os.h>
 #include <spdlog/details/synchronous_factory.h>
+#include <spdlog/details/tz_cache.h>
 #include <spdlog/fmt/fmt.h>
 #include <spdlog/sinks/base_sink.h>
 
@@ -64,6 +65,7 @@ public:
         if (max_files_ > 0) {
             init_filenames_q_();
         }
+        base_sink<Mutex>::enable_format_sharing_();
     }
 
     filename_t filename() {
@@ -73,6 +75,12 @@ public:
 
 protected:
     void sink_it_(const details::log_msg &msg) override {
+        memory_buf_t formatted;
+        base_sink<Mutex>::formatter_->format(msg, formatted);
+        sink_formatted_(msg, formatted);
+    }
+
+    void sink_formatted_(const details::log_msg &msg, const memory_buf_t &formatted) override {
         auto time = msg.time;
         bool should_rotate = time >= rotation_tp_;
         if (should_rotate) {
@@ -85,8 +93,6 @@ protected:
             rotation_tp_ = next_rotation_tp_();
         }
         remove_init_file_ = false;
-        memory_buf_t formatted;
-        base_sink<Mutex>::formatter_->format(msg, formatted);
         file_helper_.write(formatted);
 
         // Do the cleaning only at the end because it might throw on failure.
@@ -119,7 +125,7 @@ private:
 
     tm now_tm(log_clock::time_point tp) {
         time_t tnow = log_clock::to_time_t(tp);
-        return spdlog::details::os::localtime(tnow);
+        return spdlog::details::tz_cache::instance().localtime(tnow);
     }
 
     log_clock::time_point next_rotation_tp_() {
@@ -127,7 +133,8 @@ private:
         tm date = now_tm(now);
         date.tm_min = 0;
         date.tm_sec = 0;
-        auto rotation_time = log_clock::from_time_t(std::mktime(&date));
+        auto rotation_time =
+            log_clock::from_time_t(spdlog::details::tz_cache::instance().mktime(date));
         if (rotation_time > now) {
             return rotation_time;
         }
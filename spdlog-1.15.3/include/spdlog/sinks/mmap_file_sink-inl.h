@@ -0,0 +1,183 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#ifndef SPDLOG_HEADER_ONLY
+    #include <spdlog/sinks/mmap_file_sink.h>
+#endif
+
+#include <spdlog/common.h>
+
+#include <spdlog/details/file_helper.h>
+#include <spdlog/details/os.h>
+#include <spdlog/fmt/fmt.h>
+#include <spdlog/sinks/rotating_file_sink.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+namespace spdlog {
+namespace sinks {
+
+template <typename Mutex>
+SPDLOG_INLINE mmap_file_sink<Mutex>::mmap_file_sink(filename_t base_filename,
+                                                    std::size_t segment_size,
+                                                    std::size_t max_files)
+    : base_filename_(std::move(base_filename)),
+      segment_size_(segment_size),
+      max_files_(max_files),
+      current_(new details::mmap_file()),
+      next_(new details::mmap_file()) {
+    if (segment_size == 0) {
+        throw_spdlog_ex("mmap file sink constructor: segment_size arg cannot be zero");
+    }
+    if (max_files > rotating_file_sink<Mutex>::MaxFiles) {
+        throw_spdlog_ex("mmap file sink constructor: max_files arg cannot exceed MaxFiles");
+    }
+
+    // segments always start empty: keep an existing file as the first backup
+    if (details::os::path_exists(base_filename_)) {
+        shift_files_();
+        if (max_files_ > 0) {
+            rename_file_(base_filename_, calc_filename_(1));
+        }
+    }
+    current_->open(base_filename_, segment_size_, true);
+    base_sink<Mutex>::enable_format_sharing_();
+}
+
+template <typename Mutex>
+SPDLOG_INLINE mmap_file_sink<Mutex>::~mmap_file_sink() {
+    current_->close(offset_);
+    if (next_->is_open()) {
+        auto next_filename = next_->filename();
+        next_->close();
+        (void)details::os::remove(next_filename);
+    }
+}
+
+template <typename Mutex>
+SPDLOG_INLINE filename_t mmap_file_sink<Mutex>::filename() {
+    std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+    return base_filename_;
+}
+
+template <typename Mutex>
+SPDLOG_INLINE void mmap_file_sink<Mutex>::rotate_now() {
+    std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+    rotate_();
+}
+
+template <typename Mutex>
+SPDLOG_INLINE void mmap_file_sink<Mutex>::sink_it_(const details::log_msg &msg) {
+    memory_buf_t formatted;
+    base_sink<Mutex>::formatter_->format(msg, formatted);
+    sink_formatted_(msg, formatted);
+}
+
+template <typename Mutex>
+SPDLOG_INLINE void mmap_file_sink<Mutex>::sink_formatted_(const details::log_msg &,
+                                                          const memory_buf_t &formatted) {
+    if (!current_->is_open()) {
+        // a previous rotation failed half way
+        current_->open(base_filename_, segment_size_, true);
+        offset_ = 0;
+    }
+
+    const char *data = formatted.data();
+    size_t remaining = formatted.size();
+    // keep lines whole, unless a line is longer than a segment
+    if (remaining > segment_size_ - offset_ && offset_ > 0) {
+        rotate_();
+    }
+    for (;;) {
+        const size_t chunk = (std::min)(remaining, segment_size_ - offset_);
+        std::memcpy(current_->data() + offset_, data, chunk);
+        offset_ += chunk;
+        data += chunk;
+        remaining -= chunk;
+        if (remaining == 0) {
+            break;
+        }
+        rotate_();
+    }
+}
+
+template <typename Mutex>
+SPDLOG_INLINE void mmap_file_sink<Mutex>::flush_() {
+    current_->sync_async();
+    // create the next segment here, off the logging path when flushed periodically
+    if (offset_ >= segment_size_ / 2) {
+        prepare_next_();
+    }
+}
+
+// Rotate files:
+// log.txt -> log.1.txt
+// log.1.txt -> log.2.txt
+// log.2.txt -> log.3.txt
+// log.3.txt -> delete
+// log.next.txt -> log.txt
+template <typename Mutex>
+SPDLOG_INLINE void mmap_file_sink<Mutex>::rotate_() {
+    prepare_next_();
+    shift_files_();
+    if (max_files_ > 0) {
+        current_->rename(calc_filename_(1));
+        current_->close(offset_);
+    } else {
+        current_->close();
+        (void)details::os::remove(base_filename_);
+    }
+    next_->rename(base_filename_);
+    std::swap(current_, next_);
+    offset_ = 0;
+}
+
+template <typename Mutex>
+SPDLOG_INLINE void mmap_file_sink<Mutex>::prepare_next_() {
+    if (next_->is_open()) {
+        return;
+    }
+    filename_t basename;
+    filename_t ext;
+    std::tie(basename, ext) = details::file_helper::split_by_extension(base_filename_);
+    next_->open(fmt_lib::format(SPDLOG_FMT_STRING(SPDLOG_FILENAME_T("{}.next{}")), basename, ext),
+                segment_size_, true);
+}
+
+// log.1.txt -> log.2.txt ... up to max_files, the oldest is deleted
+template <typename Mutex>
+SPDLOG_INLINE void mmap_file_sink<Mutex>::shift_files_() {
+    for (auto i = max_files_; i > 1; --i) {
+        filename_t src = calc_filename_(i - 1);
+        if (details::os::path_exists(src)) {
+            rename_file_(src, calc_filename_(i));
+        }
+    }
+}
+
+template <typename Mutex>
+SPDLOG_INLINE filename_t mmap_file_sink<Mutex>::calc_filename_(std::size_t index) const {
+    return rotating_file_sink<Mutex>::calc_filename(base_filename_, index);
+}
+
+template <typename Mutex>
+SPDLOG_INLINE void mmap_file_sink<Mutex>::rename_file_(const filename_t &src_filename,
+                                                       const filename_t &target_filename) {
+    (void)details::os::remove(target_filename);
+    if (details::os::rename(src_filename, target_filename) != 0) {
+        throw_spdlog_ex("mmap_file_sink: failed renaming " +
+                            details::os::filename_to_str(src_filename) + " to " +
+                            details::os::filename_to_str(target_filename),
+                        errno);
+    }
+}
+
+}  // namespace sinks
+}  // namespace spdlog
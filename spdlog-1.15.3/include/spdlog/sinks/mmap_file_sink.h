@@ -0,0 +1,89 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <spdlog/details/mmap_file.h>
+#include <spdlog/details/null_mutex.h>
+#include <spdlog/details/synchronous_factory.h>
+#include <spdlog/sinks/base_sink.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace spdlog {
+namespace sinks {
+
+//
+// Rotating file sink writing through a memory mapping.
+// Each segment is preallocated to segment_size bytes and mapped, so logging a
+// message is a memcpy into the mapping, and what was logged survives a crash of
+// the process (the pages belong to the kernel). The next segment is created and
+// mapped ahead of time (by flush() once the current one is half full, otherwise
+// on rotation), and rotation renames files like rotating_file_sink:
+// log.txt -> log.1.txt -> log.2.txt ...
+//
+// While a segment is being written its file has the full segment size, with
+// zeros past the logged text. It is cut to its real length when the segment is
+// closed; after a crash (or a power loss) the trailing zeros remain.
+// flush() only schedules writeback (msync MS_ASYNC), it doesn't wait for it.
+//
+template <typename Mutex>
+class mmap_file_sink final : public base_sink<Mutex> {
+public:
+    mmap_file_sink(filename_t base_filename, std::size_t segment_size, std::size_t max_files);
+    ~mmap_file_sink() override;
+    filename_t filename();
+    void rotate_now();
+
+protected:
+    void sink_it_(const details::log_msg &msg) override;
+    void sink_formatted_(const details::log_msg &msg, const memory_buf_t &formatted) override;
+    void flush_() override;
+
+private:
+    void rotate_();
+    void prepare_next_();
+    void shift_files_();
+    filename_t calc_filename_(std::size_t index) const;
+    static void rename_file_(const filename_t &src_filename, const filename_t &target_filename);
+
+    filename_t base_filename_;
+    std::size_t segment_size_;
+    std::size_t max_files_;
+    std::unique_ptr<details::mmap_file> current_;
+    std::unique_ptr<details::mmap_file> next_;  // premapped segment, swapped in on rotation
+    std::size_t offset_ = 0;
+};
+
+using mmap_file_sink_mt = mmap_file_sink<std::mutex>;
+using mmap_file_sink_st = mmap_file_sink<details::null_mutex>;
+
+}  // namespace sinks
+
+//
+// factory functions
+//
+template <typename Factory = spdlog::synchronous_factory>
+std::shared_ptr<logger> mmap_logger_mt(const std::string &logger_name,
+                                       const filename_t &filename,
+                                       size_t segment_size,
+                                       size_t max_files) {
+    return Factory::template create<sinks::mmap_file_sink_mt>(logger_name, filename,
+                                                              segment_size, max_files);
+}
+
+template <typename Factory = spdlog::synchronous_factory>
+std::shared_ptr<logger> mmap_logger_st(const std::string &logger_name,
+                                       const filename_t &filename,
+                                       size_t segment_size,
+                                       size_t max_files) {
+    return Factory::template create<sinks::mmap_file_sink_st>(logger_name, filename,
+                                                              segment_size, max_files);
+}
+}  // namespace spdlog
+
+#ifdef SPDLOG_HEADER_ONLY
+    #include "mmap_file_sink-inl.h"
+#endif
@@ -0,0 +1,243 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#ifndef SPDLOG_HEADER_ONLY
+    #include <spdlog/sinks/nonblocking_console_sink.h>
+#endif
+
+#include <spdlog/details/os.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+#ifdef _WIN32
+    #include <io.h>
+#else
+    #include <climits>
+    #include <poll.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace spdlog {
+namespace sinks {
+
+SPDLOG_INLINE nonblocking_console_sink::nonblocking_console_sink(FILE *target_file,
+                                                                 size_t buffer_size,
+                                                                 color_mode mode)
+    : target_file_(target_file),
+      state_(std::make_shared<writer_state>()) {
+    state_->target_file = target_file;
+    state_->buffer.resize((std::max)(buffer_size, size_t{4096}));
+    set_color_mode_(mode);
+    colors_.at(level::trace) = "\033[37m";
+    colors_.at(level::debug) = "\033[36m";
+    colors_.at(level::info) = "\033[32m";
+    colors_.at(level::warn) = "\033[33m\033[1m";
+    colors_.at(level::err) = "\033[31m\033[1m";
+    colors_.at(level::critical) = "\033[1m\033[41m";
+    colors_.at(level::off) = "\033[m";
+
+#ifdef _WIN32
+    state_->write_limit = 64 * 1024;
+#else
+    // a pipe or a terminal reporting POLLOUT takes PIPE_BUF bytes without blocking
+    struct stat st;
+    const bool regular =
+        ::fstat(fileno(target_file_), &st) == 0 && S_ISREG(st.st_mode);
+    state_->write_limit = regular ? 1024 * 1024 : PIPE_BUF;
+#endif
+    enable_format_sharing_();
+    auto state = state_;
+    writer_ = std::thread([state] { writer_loop_(*state); });
+}
+
+SPDLOG_INLINE nonblocking_console_sink::~nonblocking_console_sink() {
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    state_->stop = true;
+    state_->cv.notify_one();
+    // the writer may be stuck in a write the console doesn't take: don't wait for it forever
+    if (state_->done_cv.wait_for(lock, std::chrono::seconds(2), [this] { return state_->done; })) {
+        lock.unlock();
+        writer_.join();
+    } else {
+        state_->abandoned = true;
+        lock.unlock();
+        writer_.detach();
+    }
+}
+
+SPDLOG_INLINE void nonblocking_console_sink::set_color(level::level_enum color_level,
+                                                       string_view_t color) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    colors_.at(static_cast<size_t>(color_level)) = std::string(color.data(), color.size());
+}
+
+SPDLOG_INLINE void nonblocking_console_sink::set_color_mode(color_mode mode) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    set_color_mode_(mode);
+}
+
+SPDLOG_INLINE bool nonblocking_console_sink::should_color() const { return should_do_colors_; }
+
+SPDLOG_INLINE size_t nonblocking_console_sink::dropped_messages() const {
+    return dropped_messages_.load(std::memory_order_relaxed);
+}
+
+SPDLOG_INLINE size_t nonblocking_console_sink::dropped_bytes() const {
+    return state_->dropped_bytes.load(std::memory_order_relaxed);
+}
+
+SPDLOG_INLINE size_t nonblocking_console_sink::pending_bytes() {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->size;
+}
+
+SPDLOG_INLINE void nonblocking_console_sink::sink_it_(const details::log_msg &msg) {
+    msg.color_range_start = 0;
+    msg.color_range_end = 0;
+    memory_buf_t formatted;
+    formatter_->format(msg, formatted);
+    sink_formatted_(msg, formatted);
+}
+
+SPDLOG_INLINE void nonblocking_console_sink::sink_formatted_(const details::log_msg &msg,
+                                                             const memory_buf_t &formatted) {
+    const bool colored = should_do_colors_ && msg.color_range_end > msg.color_range_start;
+    const auto &color = colors_[static_cast<size_t>(msg.level)];
+    const auto &reset = colors_[level::off];
+    const size_t line_size = formatted.size() + (colored ? color.size() + reset.size() : 0);
+
+    char summary[96];
+    size_t summary_size = 0;
+    if (unreported_drops_ > 0) {
+        const int n = std::snprintf(summary, sizeof(summary),
+                                    "*** %lu log messages dropped: console too slow ***\n",
+                                    static_cast<unsigned long>(unreported_drops_));
+        summary_size = n > 0 ? (std::min)(static_cast<size_t>(n), sizeof(summary) - 1) : 0;
+    }
+
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    if (state_->size + summary_size + line_size > state_->buffer.size()) {
+        unreported_drops_++;
+        dropped_messages_.fetch_add(1, std::memory_order_relaxed);
+        state_->dropped_bytes.fetch_add(formatted.size(), std::memory_order_relaxed);
+        return;
+    }
+
+    const bool was_empty = state_->size == 0;
+    if (summary_size > 0) {
+        put_(summary, summary_size);
+        unreported_drops_ = 0;
+    }
+    if (colored) {
+        put_(formatted.data(), msg.color_range_start);
+        put_(color.data(), color.size());
+        put_(formatted.data() + msg.color_range_start,
+             msg.color_range_end - msg.color_range_start);
+        put_(reset.data(), reset.size());
+        put_(formatted.data() + msg.color_range_end, formatted.size() - msg.color_range_end);
+    } else {
+        put_(formatted.data(), formatted.size());
+    }
+    lock.unlock();
+    if (was_empty) {
+        state_->cv.notify_one();  // the writer only sleeps when there is nothing to write
+    }
+}
+
+SPDLOG_INLINE void nonblocking_console_sink::flush_() { state_->cv.notify_one(); }
+
+SPDLOG_INLINE void nonblocking_console_sink::set_color_mode_(color_mode mode) {
+    switch (mode) {
+        case color_mode::always:
+            should_do_colors_ = true;
+            return;
+        case color_mode::automatic:
+            should_do_colors_ =
+                details::os::in_terminal(target_file_) && details::os::is_color_terminal();
+            return;
+        default:
+            should_do_colors_ = false;
+    }
+}
+
+SPDLOG_INLINE void nonblocking_console_sink::put_(const char *data, size_t size) {
+    auto &state = *state_;
+    const size_t capacity = state.buffer.size();
+    const size_t tail = (state.head + state.size) % capacity;
+    const size_t first = (std::min)(size, capacity - tail);
+    std::memcpy(state.buffer.data() + tail, data, first);
+    std::memcpy(state.buffer.data(), data + first, size - first);
+    state.size += size;
+}
+
+SPDLOG_INLINE void nonblocking_console_sink::writer_loop_(writer_state &state) {
+    std::unique_lock<std::mutex> lock(state.mutex);
+    for (;;) {
+        state.cv.wait(lock, [&state] { return state.stop || state.size > 0; });
+        if (state.size == 0 || state.abandoned) {
+            break;  // stopped and nothing left, or the sink didn't wait
+        }
+
+        // producers only write past the pending bytes, so this range is stable
+        const char *chunk = state.buffer.data() + state.head;
+        const size_t chunk_size =
+            (std::min)({state.size, state.buffer.size() - state.head, state.write_limit});
+        const bool stopping = state.stop;
+        lock.unlock();
+        // wait longer for a stalled console on shutdown, but not forever
+        const long written =
+            write_some_(state.target_file, chunk, chunk_size, stopping ? 1000 : 100);
+        lock.lock();
+
+        if (written > 0) {
+            state.head = (state.head + static_cast<size_t>(written)) % state.buffer.size();
+            state.size -= static_cast<size_t>(written);
+        } else if (written < 0 || stopping) {
+            // the console is gone (or still stalled on shutdown): give up on what is pending
+            state.dropped_bytes.fetch_add(state.size, std::memory_order_relaxed);
+            state.head = 0;
+            state.size = 0;
+        }
+    }
+    state.done = true;
+    state.done_cv.notify_one();
+}
+
+SPDLOG_INLINE long nonblocking_console_sink::write_some_(FILE *target_file,
+                                                         const char *data,
+                                                         size_t size,
+                                                         int timeout_ms) {
+#ifdef _WIN32
+    // no timeout: the handle may be a console, which can't be polled
+    (void)timeout_ms;
+    const int written = ::_write(_fileno(target_file), data, static_cast<unsigned int>(size));
+    return written < 0 ? -1 : written;
+#else
+    const int fd = fileno(target_file);
+    struct pollfd pfd;
+    pfd.fd = fd;
+    pfd.events = POLLOUT;
+    pfd.revents = 0;
+    const int ready = ::poll(&pfd, 1, timeout_ms);
+    if (ready <= 0) {
+        return ready == 0 || errno == EINTR ? 0 : -1;
+    }
+    if ((pfd.revents & (POLLERR | POLLHUP | POLLNVAL)) != 0) {
+        return -1;
+    }
+    const ssize_t written = ::write(fd, data, size);
+    if (written < 0) {
+        return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR ? 0 : -1;
+    }
+    return static_cast<long>(written);
+#endif
+}
+
+}  // namespace sinks
+}  // namespace spdlog
@@ -0,0 +1,105 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <spdlog/sinks/base_sink.h>
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace spdlog {
+namespace sinks {
+
+/*
+ * Console sink that never makes the logging threads wait for the console.
+ *
+ * Messages are formatted (with ANSI colors, like ansicolor_sink) into a bounded
+ * in-memory buffer, which a thread of the sink writes to the console. When the
+ * console doesn't keep up (slow terminal, paused pager, full pipe) and the
+ * buffer is full, messages are dropped and counted; once there is room again a
+ * line telling how many were dropped is written before the next message.
+ *
+ * The console mutex isn't used, so the output isn't serialized with the other
+ * console sinks. flush() only wakes the writer thread, it doesn't wait for it.
+ *
+ * A terminal can report room and still block a write (e.g. paused with Ctrl-S),
+ * and on Windows writes are never bounded by a timeout. The writer thread is then
+ * stuck in the write and the messages are dropped meanwhile. Destruction waits at
+ * most 2 seconds for the pending output, then leaves a stuck writer thread behind:
+ * it exits once its write returns.
+ */
+class SPDLOG_API nonblocking_console_sink final : public base_sink<std::mutex> {
+public:
+    static constexpr size_t default_buffer_size = 1024 * 1024;
+
+    explicit nonblocking_console_sink(FILE *target_file = stdout,
+                                      size_t buffer_size = default_buffer_size,
+                                      color_mode mode = color_mode::automatic);
+    ~nonblocking_console_sink() override;
+
+    void set_color(level::level_enum color_level, string_view_t color);
+    void set_color_mode(color_mode mode);
+    bool should_color() const;
+
+    // messages (and their bytes) dropped because the buffer was full
+    size_t dropped_messages() const;
+    size_t dropped_bytes() const;
+    // bytes waiting to be written
+    size_t pending_bytes();
+
+protected:
+    void sink_it_(const details::log_msg &msg) override;
+    void sink_formatted_(const details::log_msg &msg, const memory_buf_t &formatted) override;
+    void flush_() override;
+
+private:
+    // what the writer thread uses, shared with it: it may outlive the sink
+    struct writer_state {
+        FILE *target_file;
+        size_t write_limit;  // largest write the console takes without blocking
+
+        std::mutex mutex;
+        std::condition_variable cv;       // new data or stop
+        std::condition_variable done_cv;  // the writer is done
+        // ring buffer, guarded by mutex. the writer thread reads [head, head + size).
+        std::vector<char> buffer;
+        size_t head = 0;
+        size_t size = 0;
+        bool stop = false;
+        bool abandoned = false;  // the sink is gone, give up on what is pending
+        bool done = false;
+        std::atomic<size_t> dropped_bytes{0};
+    };
+
+    FILE *target_file_;
+    bool should_do_colors_ = false;
+    std::array<std::string, level::n_levels> colors_;
+    size_t unreported_drops_ = 0;
+    std::atomic<size_t> dropped_messages_{0};
+
+    std::shared_ptr<writer_state> state_;
+    std::thread writer_;
+
+    void set_color_mode_(color_mode mode);
+    // caller holds state_->mutex and checked there is room
+    void put_(const char *data, size_t size);
+    static void writer_loop_(writer_state &state);
+    // write to the console, waiting at most timeout_ms for it to accept data.
+    // return the number of bytes written, or -1 if the console is gone.
+    static long write_some_(FILE *target_file, const char *data, size_t size, int timeout_ms);
+};
+
+}  // namespace sinks
+}  // namespace spdlog
+
+#ifdef SPDLOG_HEADER_ONLY
+    #include "nonblocking_console_sink-inl.h"
+#endif
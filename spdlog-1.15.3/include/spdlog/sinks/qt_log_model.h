@@ -0,0 +1,351 @@
+// Copyright(c) 2015-present, Gabi Melman, mguludag and spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+//
+// Log view for Qt item views (QListView...), as an alternative to qt_color_sink for high
+// message rates. Building and using requires Qt library.
+//
+// qt_log_model keeps the last lines in a fixed capacity ring buffer, qt_model_sink feeds it and
+// qt_log_delegate paints the lines with their level colors:
+//
+//     auto *model = new spdlog::sinks::qt_log_model(100000, view);
+//     view->setModel(model);
+//     view->setItemDelegate(new spdlog::sinks::qt_log_delegate(false, view));
+//     view->setUniformItemSizes(true);
+//     auto logger = spdlog::qt_model_logger_mt("gui", model);
+//
+// The view only lays out and paints the visible rows (with uniform item sizes it doesn't measure
+// the others), so the cost of a frame doesn't depend on the number of lines held.
+//
+
+#include "spdlog/common.h"
+#include "spdlog/details/log_msg.h"
+#include "spdlog/details/null_mutex.h"
+#include "spdlog/details/synchronous_factory.h"
+#include "spdlog/sinks/base_sink.h"
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <QAbstractListModel>
+#include <QPainter>
+#include <QStyle>
+#include <QStyledItemDelegate>
+
+namespace spdlog {
+namespace sinks {
+
+// a line of qt_log_model. the color range is in characters of text.
+struct qt_log_line {
+    QString text;
+    level::level_enum level = level::off;
+    int color_range_start = 0;
+    int color_range_end = 0;
+};
+
+// List model of the last capacity log lines.
+// Appending to a full model removes the oldest lines: each append() signals one removal of the
+// first rows and one insertion at the end, whatever the number of lines.
+// Not thread safe: use it in the GUI thread (qt_model_sink takes care of that).
+class qt_log_model : public QAbstractListModel {
+public:
+    enum roles { level_role = Qt::UserRole, color_range_start_role, color_range_end_role };
+
+    explicit qt_log_model(int capacity, QObject *parent = nullptr)
+        : QAbstractListModel(parent),
+          lines_(static_cast<size_t>((std::max)(capacity, 1))) {}
+
+    int capacity() const { return static_cast<int>(lines_.size()); }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override {
+        return parent.isValid() ? 0 : size_;
+    }
+
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override {
+        if (!index.isValid() || index.row() < 0 || index.row() >= size_) {
+            return QVariant();
+        }
+        const qt_log_line &l = line(index.row());
+        switch (role) {
+            case Qt::DisplayRole:
+                return l.text;
+            case level_role:
+                return static_cast<int>(l.level);
+            case color_range_start_role:
+                return l.color_range_start;
+            case color_range_end_role:
+                return l.color_range_end;
+            default:
+                return QVariant();
+        }
+    }
+
+    const qt_log_line &line(int row) const {
+        return lines_[(first_ + static_cast<size_t>(row)) % lines_.size()];
+    }
+
+    // append the lines, moving from them
+    template <typename It>
+    void append(It first, It last) {
+        const int cap = capacity();
+        auto count = static_cast<int>(std::distance(first, last));
+        if (count > cap) {
+            // would be removed right away
+            std::advance(first, count - cap);
+            count = cap;
+        }
+        if (count == 0) {
+            return;
+        }
+
+        const int overflow = size_ + count - cap;
+        if (overflow > 0) {
+            beginRemoveRows(QModelIndex(), 0, overflow - 1);
+            first_ = (first_ + static_cast<size_t>(overflow)) % lines_.size();
+            size_ -= overflow;
+            endRemoveRows();
+        }
+
+        beginInsertRows(QModelIndex(), size_, size_ + count - 1);
+        for (; first != last; ++first) {
+            lines_[(first_ + static_cast<size_t>(size_)) % lines_.size()] = std::move(*first);
+            size_++;
+        }
+        endInsertRows();
+    }
+
+    void clear() {
+        beginResetModel();
+        for (auto &l : lines_) {
+            l = qt_log_line();
+        }
+        first_ = 0;
+        size_ = 0;
+        endResetModel();
+    }
+
+private:
+    std::vector<qt_log_line> lines_;
+    size_t first_ = 0;  // index of row 0 in lines_
+    int size_ = 0;
+};
+
+// Delegate painting the lines of qt_log_model (or of a proxy model over it) on a single text line,
+// with the color range in the color of the level.
+class qt_log_delegate : public QStyledItemDelegate {
+public:
+    explicit qt_log_delegate(bool dark_colors = false, QObject *parent = nullptr)
+        : QStyledItemDelegate(parent) {
+        // same colors as qt_color_sink
+        colors_.at(level::trace).foreground = dark_colors ? Qt::darkGray : Qt::gray;
+        colors_.at(level::debug).foreground = dark_colors ? Qt::darkCyan : Qt::cyan;
+        colors_.at(level::info).foreground = dark_colors ? Qt::darkGreen : Qt::green;
+        colors_.at(level::warn).foreground = dark_colors ? Qt::darkYellow : Qt::yellow;
+        colors_.at(level::err).foreground = Qt::red;
+        colors_.at(level::critical).foreground = Qt::white;
+        colors_.at(level::critical).background = Qt::red;
+    }
+
+    // an invalid QColor keeps the default one
+    void set_level_color(level::level_enum color_level,
+                         QColor foreground,
+                         QColor background = QColor()) {
+        colors_.at(static_cast<size_t>(color_level)) = level_color{foreground, background};
+    }
+
+    void paint(QPainter *painter,
+               const QStyleOptionViewItem &option,
+               const QModelIndex &index) const override {
+        const QString text = index.data(Qt::DisplayRole).toString();
+        const int lvl = index.data(qt_log_model::level_role).toInt();
+        const int text_size = static_cast<int>(text.size());
+        const int start = (std::min)(
+            (std::max)(index.data(qt_log_model::color_range_start_role).toInt(), 0), text_size);
+        const int end = (std::min)(
+            (std::max)(index.data(qt_log_model::color_range_end_role).toInt(), start), text_size);
+        const bool selected = (option.state & QStyle::State_Selected) != 0;
+        const QColor text_color =
+            option.palette.color(selected ? QPalette::HighlightedText : QPalette::Text);
+
+        painter->save();
+        painter->setFont(option.font);
+        if (selected) {
+            painter->fillRect(option.rect, option.palette.highlight());
+        }
+        QRect rect = option.rect;
+        draw_part_(painter, option, rect, text.left(start), text_color, QColor());
+        if (end > start && lvl >= 0 && lvl < static_cast<int>(level::n_levels)) {
+            const level_color &color = colors_.at(static_cast<size_t>(lvl));
+            draw_part_(painter, option, rect, text.mid(start, end - start),
+                       selected || !color.foreground.isValid() ? text_color : color.foreground,
+                       selected ? QColor() : color.background);
+        }
+        draw_part_(painter, option, rect, text.mid(end), text_color, QColor());
+        painter->restore();
+    }
+
+    QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const override {
+        return QSize(advance_(option, index.data(Qt::DisplayRole).toString()),
+                     option.fontMetrics.height());
+    }
+
+private:
+    struct level_color {
+        QColor foreground;
+        QColor background;
+    };
+    std::array<level_color, level::n_levels> colors_;
+
+    static int advance_(const QStyleOptionViewItem &option, const QString &text) {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 11, 0)
+        return option.fontMetrics.horizontalAdvance(text);
+#else
+        return option.fontMetrics.width(text);
+#endif
+    }
+
+    // draw text at the left of rect, and move the left of rect past it
+    static void draw_part_(QPainter *painter,
+                           const QStyleOptionViewItem &option,
+                           QRect &rect,
+                           const QString &text,
+                           const QColor &foreground,
+                           const QColor &background) {
+        if (text.isEmpty()) {
+            return;
+        }
+        const int width = advance_(option, text);
+        if (background.isValid()) {
+            painter->fillRect(QRect(rect.left(), rect.top(), width, rect.height()), background);
+        }
+        painter->setPen(foreground);
+        painter->drawText(rect, Qt::AlignLeft | Qt::AlignVCenter | Qt::TextSingleLine, text);
+        rect.setLeft(rect.left() + width);
+    }
+};
+
+// Sink appending to a qt_log_model.
+// The lines are collected and handed to the model at most once per event loop iteration of the
+// model's thread. At most capacity lines wait: older ones would be pushed out of the model anyway,
+// so they are dropped first.
+// By default, only ascii (latin1) is supported by this sink. Set is_utf8 to true if utf8 support
+// is needed.
+template <typename Mutex>
+class qt_model_sink : public base_sink<Mutex> {
+public:
+    explicit qt_model_sink(qt_log_model *model, bool is_utf8 = false)
+        : model_(model),
+          is_utf8_(is_utf8),
+          state_(std::make_shared<shared_state>()) {
+        if (!model_) {
+            throw_spdlog_ex("qt_model_sink: model is null");
+        }
+        state_->capacity = static_cast<size_t>(model_->capacity());
+    }
+
+protected:
+    // shared with the posted invocations, which may run after the sink is gone
+    struct shared_state {
+        size_t capacity;
+        std::mutex mutex;
+        std::deque<qt_log_line> pending;
+        bool posted = false;
+    };
+
+    void sink_it_(const details::log_msg &msg) override {
+        memory_buf_t formatted;
+        base_sink<Mutex>::formatter_->format(msg, formatted);
+
+        // one row per message: drop the eol
+        size_t size = formatted.size();
+        while (size > 0 && (formatted[size - 1] == '\n' || formatted[size - 1] == '\r')) {
+            size--;
+        }
+        const char *data = formatted.data();
+
+        qt_log_line line;
+        line.level = msg.level;
+        size_t color_range_start = (std::min)(msg.color_range_start, size);
+        size_t color_range_end = (std::min)(msg.color_range_end, size);
+        if (is_utf8_) {
+            line.text = QString::fromUtf8(data, static_cast<int>(size));
+            // convert color ranges from byte index to character index.
+            if (color_range_start < color_range_end) {
+                line.color_range_start = static_cast<int>(
+                    QString::fromUtf8(data, static_cast<int>(color_range_start)).size());
+                line.color_range_end = static_cast<int>(
+                    QString::fromUtf8(data, static_cast<int>(color_range_end)).size());
+            }
+        } else {
+            line.text = QString::fromLatin1(data, static_cast<int>(size));
+            line.color_range_start = static_cast<int>(color_range_start);
+            line.color_range_end = static_cast<int>(color_range_end);
+        }
+
+        bool post;
+        {
+            std::lock_guard<std::mutex> lock(state_->mutex);
+            if (state_->pending.size() >= state_->capacity) {
+                state_->pending.pop_front();
+            }
+            state_->pending.push_back(std::move(line));
+            post = !state_->posted;
+            state_->posted = true;
+        }
+        if (post) {
+            std::shared_ptr<shared_state> state = state_;
+            qt_log_model *model = model_;
+            // not run if the model is destroyed meanwhile
+            QMetaObject::invokeMethod(
+                model, [state, model]() { deliver_(*state, model); }, Qt::QueuedConnection);
+        }
+    }
+
+    void flush_() override {}
+
+    // invoked in the thread of the model
+    static void deliver_(shared_state &state, qt_log_model *model) {
+        std::deque<qt_log_line> lines;
+        {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            lines.swap(state.pending);
+            state.posted = false;
+        }
+        model->append(lines.begin(), lines.end());
+    }
+
+    qt_log_model *model_;
+    bool is_utf8_;
+    std::shared_ptr<shared_state> state_;
+};
+
+using qt_model_sink_mt = qt_model_sink<std::mutex>;
+using qt_model_sink_st = qt_model_sink<details::null_mutex>;
+}  // namespace sinks
+
+//
+// Factory functions
+//
+
+// log to qt_log_model
+template <typename Factory = spdlog::synchronous_factory>
+inline std::shared_ptr<logger> qt_model_logger_mt(const std::string &logger_name,
+                                                  sinks::qt_log_model *model,
+                                                  bool is_utf8 = false) {
+    return Factory::template create<sinks::qt_model_sink_mt>(logger_name, model, is_utf8);
+}
+
+template <typename Factory = spdlog::synchronous_factory>
+inline std::shared_ptr<logger> qt_model_logger_st(const std::string &logger_name,
+                                                  sinks::qt_log_model *model,
+                                                  bool is_utf8 = false) {
+    return Factory::template create<sinks::qt_model_sink_st>(logger_name, model, is_utf8);
+}
+
+}  // namespace spdlog
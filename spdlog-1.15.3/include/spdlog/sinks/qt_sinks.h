@@ -17,9 +17,16 @@
 #include "spdlog/details/synchronous_factory.h"
 #include "spdlog/sinks/base_sink.h"
 #include <array>
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
 
 #include <QPlainTextEdit>
+#include <QStringList>
 #include <QTextEdit>
+#include <QTimer>
 
 //
 // qt_sink class
@@ -56,12 +63,125 @@ private:
     std::string meta_method_;
 };
 
+// Qt sink delivering the messages in batches.
+// Lines are collected and the slot is invoked at most once per event loop iteration of the
+// target object's thread (or once every interval_ms), with all the lines collected meanwhile,
+// instead of once per message. The slot takes a QStringList, or with join_lines a QString
+// holding the lines separated by '\n' (e.g. QPlainTextEdit::appendPlainText).
+// At most max_pending lines wait for delivery. Further lines are dropped, counted by dropped(),
+// and reported by a line of the next batch.
+template <typename Mutex>
+class qt_batch_sink : public base_sink<Mutex> {
+public:
+    qt_batch_sink(QObject *qt_object,
+                  std::string meta_method,
+                  bool join_lines = false,
+                  size_t max_pending = 10000,
+                  int interval_ms = 0)
+        : qt_object_(qt_object),
+          state_(std::make_shared<shared_state>()) {
+        if (!qt_object_) {
+            throw_spdlog_ex("qt_batch_sink: qt_object is null");
+        }
+        state_->qt_object = qt_object;
+        state_->meta_method = std::move(meta_method);
+        state_->join_lines = join_lines;
+        state_->max_pending = max_pending;
+        state_->interval_ms = interval_ms;
+    }
+
+    size_t dropped() const { return state_->dropped_total.load(std::memory_order_relaxed); }
+
+protected:
+    // shared with the posted invocations, which may run after the sink is gone
+    struct shared_state {
+        QObject *qt_object;
+        std::string meta_method;
+        bool join_lines;
+        size_t max_pending;
+        int interval_ms;
+
+        std::mutex mutex;
+        QStringList pending;
+        size_t dropped = 0;  // since the last delivery
+        bool posted = false;
+        std::atomic<size_t> dropped_total{0};
+    };
+
+    void sink_it_(const details::log_msg &msg) override {
+        memory_buf_t formatted;
+        base_sink<Mutex>::formatter_->format(msg, formatted);
+        QString line =
+            QString::fromUtf8(formatted.data(), static_cast<int>(formatted.size())).trimmed();
+
+        bool post;
+        {
+            // the GUI thread only holds it to swap the list out
+            std::lock_guard<std::mutex> lock(state_->mutex);
+            if (static_cast<size_t>(state_->pending.size()) >= state_->max_pending) {
+                state_->dropped++;
+                state_->dropped_total.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            state_->pending.append(std::move(line));
+            post = !state_->posted;
+            state_->posted = true;
+        }
+        if (post) {
+            std::shared_ptr<shared_state> state = state_;
+            QMetaObject::invokeMethod(
+                qt_object_,
+                [state]() {
+                    if (state->interval_ms > 0) {
+                        QTimer::singleShot(state->interval_ms, state->qt_object,
+                                           [state]() { deliver_(*state); });
+                    } else {
+                        deliver_(*state);
+                    }
+                },
+                Qt::QueuedConnection);
+        }
+    }
+
+    void flush_() override {}
+
+    // invoked in the thread of the target object
+    static void deliver_(shared_state &state) {
+        QStringList lines;
+        size_t dropped;
+        {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            lines.swap(state.pending);
+            dropped = state.dropped;
+            state.dropped = 0;
+            state.posted = false;
+        }
+        if (dropped > 0) {
+            lines.append(QStringLiteral("*** %1 log messages dropped ***")
+                             .arg(static_cast<qulonglong>(dropped)));
+        }
+        if (state.join_lines) {
+            QMetaObject::invokeMethod(state.qt_object, state.meta_method.c_str(),
+                                      Qt::DirectConnection,
+                                      Q_ARG(QString, lines.join(QLatin1Char('\n'))));
+        } else {
+            QMetaObject::invokeMethod(state.qt_object, state.meta_method.c_str(),
+                                      Qt::DirectConnection, Q_ARG(QStringList, lines));
+        }
+    }
+
+    QObject *qt_object_;
+    std::shared_ptr<shared_state> state_;
+};
+
 // Qt color sink to QTextEdit.
 // Color location is determined by the sink log pattern like in the rest of spdlog sinks.
 // Colors can be modified if needed using sink->set_color(level, qtTextCharFormat).
 // max_lines is the maximum number of lines that the sink will hold before removing the oldest
 // lines. By default, only ascii (latin1) is supported by this sink. Set is_utf8 to true if utf8
 // support is needed.
+// Messages are collected and added to the text edit at most once per event loop iteration of the
+// GUI thread, in a single edit block.
 template <typename Mutex>
 class qt_color_sink : public base_sink<Mutex> {
 public:
@@ -71,10 +191,13 @@ public:
                   bool is_utf8 = false)
         : qt_text_edit_(qt_text_edit),
           max_lines_(max_lines),
-          is_utf8_(is_utf8) {
+          is_utf8_(is_utf8),
+          state_(std::make_shared<shared_state>()) {
         if (!qt_text_edit_) {
             throw_spdlog_ex("qt_color_text_sink: text_edit is null");
         }
+        state_->q_text_edit = qt_text_edit;
+        state_->max_lines = max_lines;
 
         default_color_ = qt_text_edit_->currentCharFormat();
         // set colors
@@ -124,22 +247,16 @@ public:
 
 protected:
     struct invoke_params {
-        invoke_params(int max_lines,
-                      QTextEdit *q_text_edit,
-                      QString payload,
+        invoke_params(QString payload,
                       QTextCharFormat default_color,
                       QTextCharFormat level_color,
                       int color_range_start,
                       int color_range_end)
-            : max_lines(max_lines),
-              q_text_edit(q_text_edit),
-              payload(std::move(payload)),
+            : payload(std::move(payload)),
               default_color(default_color),
               level_color(level_color),
               color_range_start(color_range_start),
               color_range_end(color_range_end) {}
-        int max_lines;
-        QTextEdit *q_text_edit;
         QString payload;
         QTextCharFormat default_color;
         QTextCharFormat level_color;
@@ -147,6 +264,15 @@ protected:
         int color_range_end;
     };
 
+    // shared with the posted invocations, which may run after the sink is gone
+    struct shared_state {
+        QTextEdit *q_text_edit;
+        int max_lines;
+        std::mutex mutex;
+        std::deque<invoke_params> pending;
+        bool posted = false;
+    };
+
     void sink_it_(const details::log_msg &msg) override {
         memory_buf_t formatted;
         base_sink<Mutex>::formatter_->format(msg, formatted);
@@ -167,36 +293,64 @@ protected:
             payload = QString::fromLatin1(str.data(), static_cast<int>(str.size()));
         }
 
-        invoke_params params{max_lines_,             // max lines
-                             qt_text_edit_,          // text edit to append to
-                             std::move(payload),     // text to append
+        invoke_params params{std::move(payload),     // text to append
                              default_color_,         // default color
                              colors_.at(msg.level),  // color to apply
                              color_range_start,      // color range start
                              color_range_end};       // color range end
 
-        QMetaObject::invokeMethod(
-            qt_text_edit_, [params]() { invoke_method_(params); }, Qt::AutoConnection);
+        bool post;
+        {
+            std::lock_guard<std::mutex> lock(state_->mutex);
+            // messages past max_lines would be removed right away
+            if (state_->pending.size() >= static_cast<size_t>((std::max)(max_lines_, 1))) {
+                state_->pending.pop_front();
+            }
+            state_->pending.push_back(std::move(params));
+            post = !state_->posted;
+            state_->posted = true;
+        }
+        if (post) {
+            std::shared_ptr<shared_state> state = state_;
+            QMetaObject::invokeMethod(
+                qt_text_edit_, [state]() { invoke_method_(*state); }, Qt::QueuedConnection);
+        }
     }
 
     void flush_() override {}
 
-    // Add colored text to the text edit widget. This method is invoked in the GUI thread.
-    // It is a static method to ensure that it is handled correctly even if the sink is destroyed
-    // prematurely before it is invoked.
+    // Add the pending colored text to the text edit widget. This method is invoked in the GUI
+    // thread. It is a static method to ensure that it is handled correctly even if the sink is
+    // destroyed prematurely before it is invoked.
 
-    static void invoke_method_(invoke_params params) {
-        auto *document = params.q_text_edit->document();
+    static void invoke_method_(shared_state &state) {
+        std::deque<invoke_params> pending;
+        {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            pending.swap(state.pending);
+            state.posted = false;
+        }
+
+        auto *document = state.q_text_edit->document();
         QTextCursor cursor(document);
+        // a single layout update and undo step for the whole batch
+        cursor.beginEditBlock();
+        cursor.movePosition(QTextCursor::End);
+        for (const auto &params : pending) {
+            insert_(cursor, params);
+        }
 
-        // remove first blocks if number of blocks exceeds max_lines
-        while (document->blockCount() > params.max_lines) {
-            cursor.select(QTextCursor::BlockUnderCursor);
+        // remove first blocks if number of blocks exceeds max_lines, with a single selection
+        const int excess = document->blockCount() - state.max_lines;
+        if (excess > 0) {
+            cursor.movePosition(QTextCursor::Start);
+            cursor.movePosition(QTextCursor::NextBlock, QTextCursor::KeepAnchor, excess);
             cursor.removeSelectedText();
-            cursor.deleteChar();  // delete the newline after the block
         }
+        cursor.endEditBlock();
+    }
 
-        cursor.movePosition(QTextCursor::End);
+    static void insert_(QTextCursor &cursor, const invoke_params &params) {
         cursor.setCharFormat(params.default_color);
 
         // if color range not specified or not not valid, just append the text with default color
@@ -223,6 +377,7 @@ protected:
     bool is_utf8_;
     QTextCharFormat default_color_;
     std::array<QTextCharFormat, level::n_levels> colors_;
+    std::shared_ptr<shared_state> state_;
 };
 
 #include "spdlog/details/null_mutex.h"
@@ -230,6 +385,8 @@ protected:
 
 using qt_sink_mt = qt_sink<std::mutex>;
 using qt_sink_st = qt_sink<details::null_mutex>;
+using qt_batch_sink_mt = qt_batch_sink<std::mutex>;
+using qt_batch_sink_st = qt_batch_sink<details::null_mutex>;
 using qt_color_sink_mt = qt_color_sink<std::mutex>;
 using qt_color_sink_st = qt_color_sink<details::null_mutex>;
 }  // namespace sinks
@@ -282,6 +439,42 @@ inline std::shared_ptr<logger> qt_logger_st(const std::string &logger_name,
     return Factory::template create<sinks::qt_sink_st>(logger_name, qt_object, meta_method);
 }
 
+// log to QPlainTextEdit, appending the lines collected during an event loop iteration at once
+template <typename Factory = spdlog::synchronous_factory>
+inline std::shared_ptr<logger> qt_batch_logger_mt(const std::string &logger_name,
+                                                  QPlainTextEdit *qt_object,
+                                                  size_t max_pending = 10000) {
+    return Factory::template create<sinks::qt_batch_sink_mt>(logger_name, qt_object,
+                                                             "appendPlainText", true, max_pending);
+}
+
+template <typename Factory = spdlog::synchronous_factory>
+inline std::shared_ptr<logger> qt_batch_logger_st(const std::string &logger_name,
+                                                  QPlainTextEdit *qt_object,
+                                                  size_t max_pending = 10000) {
+    return Factory::template create<sinks::qt_batch_sink_st>(logger_name, qt_object,
+                                                             "appendPlainText", true, max_pending);
+}
+
+// log to QObject, whose meta_method takes a QStringList
+template <typename Factory = spdlog::synchronous_factory>
+inline std::shared_ptr<logger> qt_batch_logger_mt(const std::string &logger_name,
+                                                  QObject *qt_object,
+                                                  const std::string &meta_method,
+                                                  size_t max_pending = 10000) {
+    return Factory::template create<sinks::qt_batch_sink_mt>(logger_name, qt_object, meta_method,
+                                                             false, max_pending);
+}
+
+template <typename Factory = spdlog::synchronous_factory>
+inline std::shared_ptr<logger> qt_batch_logger_st(const std::string &logger_name,
+                                                  QObject *qt_object,
+                                                  const std::string &meta_method,
+                                                  size_t max_pending = 10000) {
+    return Factory::template create<sinks::qt_batch_sink_st>(logger_name, qt_object, meta_method,
+                                                             false, max_pending);
+}
+
 // log to QTextEdit with colorized output
 template <typename Factory = spdlog::synchronous_factory>
 inline std::shared_ptr<logger> qt_color_logger_mt(const std::string &logger_name,
@@ -3,11 +3,12 @@
 
 #pragma once
 
-#include "spdlog/details/circular_q.h"
 #include "spdlog/details/log_msg_buffer.h"
 #include "spdlog/details/null_mutex.h"
+#include "spdlog/details/record_ring.h"
 #include "spdlog/sinks/base_sink.h"
 
+#include <cstring>
 #include <mutex>
 #include <string>
 #include <vector>
@@ -16,47 +17,122 @@ namespace spdlog {
 namespace sinks {
 /*
  * Ring buffer sink
+ *
+ * Keeps the last n_items messages that fit in buffer_size bytes, formatted when logged. The
+ * messages are copied into a single buffer allocated up front, so logging doesn't allocate.
+ * The default buffer holds n_items messages of up to default_item_size bytes of text (logger
+ * name, payload and formatted message): with the default pattern, payloads of about 200
+ * characters. A message larger than the whole buffer isn't kept.
  */
 template <typename Mutex>
 class ringbuffer_sink final : public base_sink<Mutex> {
 public:
-    explicit ringbuffer_sink(size_t n_items)
-        : q_{n_items} {}
+    static constexpr size_t default_item_size = 512;
+
+    // buffer_size: 0 for room for n_items messages of default_item_size bytes of text
+    explicit ringbuffer_sink(size_t n_items, size_t buffer_size = 0)
+        : max_items_(n_items),
+          records_{buffer_size > 0 ? buffer_size : default_buffer_size_(n_items)} {
+        base_sink<Mutex>::enable_format_sharing_();
+    }
 
     std::vector<details::log_msg_buffer> last_raw(size_t lim = 0) {
         std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
-        auto items_available = q_.size();
-        auto n_items = lim > 0 ? (std::min)(lim, items_available) : items_available;
         std::vector<details::log_msg_buffer> ret;
-        ret.reserve(n_items);
-        for (size_t i = (items_available - n_items); i < items_available; i++) {
-            ret.push_back(q_.at(i));
-        }
+        ret.reserve(n_last_(lim));
+        records_.for_each([&ret](string_view_t record) { ret.emplace_back(read_msg_(record)); },
+                          records_.size() - n_last_(lim));
         return ret;
     }
 
+    // the messages as formatted when they were logged: a later set_pattern() or
+    // set_formatter() doesn't change them.
     std::vector<std::string> last_formatted(size_t lim = 0) {
         std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
-        auto items_available = q_.size();
-        auto n_items = lim > 0 ? (std::min)(lim, items_available) : items_available;
         std::vector<std::string> ret;
-        ret.reserve(n_items);
-        for (size_t i = (items_available - n_items); i < items_available; i++) {
-            memory_buf_t formatted;
-            base_sink<Mutex>::formatter_->format(q_.at(i), formatted);
-            ret.push_back(SPDLOG_BUF_TO_STRING(formatted));
-        }
+        ret.reserve(n_last_(lim));
+        records_.for_each(
+            [&ret](string_view_t record) {
+                const string_view_t formatted = read_formatted_(record);
+                ret.emplace_back(formatted.data(), formatted.size());
+            },
+            records_.size() - n_last_(lim));
         return ret;
     }
 
+    // call func(string_view_t formatted) for the last lim messages (all if 0), oldest first,
+    // as formatted when logged, without copying them. it runs under the sink lock: the views are only valid during the
+    // call and func mustn't log to this sink.
+    template <typename Func>
+    void for_each_formatted(Func func, size_t lim = 0) {
+        std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+        records_.for_each([&func](string_view_t record) { func(read_formatted_(record)); },
+                          records_.size() - n_last_(lim));
+    }
+
 protected:
     void sink_it_(const details::log_msg &msg) override {
-        q_.push_back(details::log_msg_buffer{msg});
+        formatted_.clear();  // keeps its capacity
+        base_sink<Mutex>::formatter_->format(msg, formatted_);
+        sink_formatted_(msg, formatted_);
     }
+
+    // record: the log_msg, the logger name, the payload, the formatted message
+    void sink_formatted_(const details::log_msg &msg, const memory_buf_t &formatted) override {
+        if (max_items_ == 0) {
+            return;
+        }
+        if (records_.size() >= max_items_) {
+            records_.pop_front();
+        }
+        char *record = records_.push_back(sizeof(details::log_msg) + msg.logger_name.size() +
+                                          msg.payload.size() + formatted.size());
+        if (record == nullptr) {
+            return;
+        }
+        std::memcpy(record, &msg, sizeof(details::log_msg));
+        record += sizeof(details::log_msg);
+        std::memcpy(record, msg.logger_name.data(), msg.logger_name.size());
+        record += msg.logger_name.size();
+        std::memcpy(record, msg.payload.data(), msg.payload.size());
+        record += msg.payload.size();
+        std::memcpy(record, formatted.data(), formatted.size());
+    }
+
     void flush_() override {}
 
 private:
-    details::circular_q<details::log_msg_buffer> q_;
+    size_t max_items_;
+    details::record_ring records_;
+    memory_buf_t formatted_;
+
+    // each record also holds its size and the log_msg
+    static size_t default_buffer_size_(size_t n_items) {
+        return n_items *
+               (details::record_ring::header_size + sizeof(details::log_msg) + default_item_size);
+    }
+
+    size_t n_last_(size_t lim) const {
+        return lim > 0 ? (std::min)(lim, records_.size()) : records_.size();
+    }
+
+    // the stored log_msg, with the views pointing into the record
+    static details::log_msg read_msg_(string_view_t record) {
+        details::log_msg msg;
+        std::memcpy(&msg, record.data(), sizeof(details::log_msg));
+        const char *data = record.data() + sizeof(details::log_msg);
+        msg.logger_name = string_view_t(data, msg.logger_name.size());
+        data += msg.logger_name.size();
+        msg.payload = string_view_t(data, msg.payload.size());
+        return msg;
+    }
+
+    static string_view_t read_formatted_(string_view_t record) {
+        const details::log_msg msg = read_msg_(record);
+        const size_t offset =
+            sizeof(details::log_msg) + msg.logger_name.size() + msg.payload.size();
+        return string_view_t(record.data() + offset, record.size() - offset);
+    }
 };
 
 using ringbuffer_sink_mt = ringbuffer_sink<std::mutex>;
@@ -46,6 +46,7 @@ SPDLOG_INLINE rotating_file_sink<Mutex>::rotating_file_sink(
         rotate_();
         current_size_ = 0;
     }
+    base_sink<Mutex>::enable_format_sharing_();
 }
 
 // calc filename according to index and file extension if exists.
@@ -108,6 +109,12 @@ template <typename Mutex>
 SPDLOG_INLINE void rotating_file_sink<Mutex>::sink_it_(const details::log_msg &msg) {
     memory_buf_t formatted;
     base_sink<Mutex>::formatter_->format(msg, formatted);
+    sink_formatted_(msg, formatted);
+}
+
+template <typename Mutex>
+SPDLOG_INLINE void rotating_file_sink<Mutex>::sink_formatted_(const details::log_msg &,
+                                                              const memory_buf_t &formatted) {
     auto new_size = current_size_ + formatted.size();
 
     // rotate if the new estimated file size exceeds max size.
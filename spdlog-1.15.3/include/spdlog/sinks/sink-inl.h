@@ -9,6 +9,10 @@
 
 #include <spdlog/common.h>
 
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
 SPDLOG_INLINE bool spdlog::sinks::sink::should_log(spdlog::level::level_enum msg_level) const {
     return msg_level >= level_.load(std::memory_order_relaxed);
 }
@@ -20,3 +24,37 @@ SPDLOG_INLINE void spdlog::sinks::sink::set_level(level::level_enum log_level) {
 SPDLOG_INLINE spdlog::level::level_enum spdlog::sinks::sink::level() const {
     return static_cast<spdlog::level::level_enum>(level_.load(std::memory_order_relaxed));
 }
+
+SPDLOG_INLINE uint64_t spdlog::sinks::sink::format_key() const {
+    return format_key_.load(std::memory_order_relaxed);
+}
+
+SPDLOG_INLINE void spdlog::sinks::sink::log_and_format(const details::log_msg &msg,
+                                                       memory_buf_t &) {
+    log(msg);
+}
+
+SPDLOG_INLINE void spdlog::sinks::sink::log_formatted(const details::log_msg &msg,
+                                                      const memory_buf_t &) {
+    log(msg);
+}
+
+SPDLOG_INLINE uint64_t spdlog::sinks::sink::format_key_of_(const spdlog::formatter *f) {
+    if (f == nullptr) {
+        return 0;
+    }
+    auto signature = f->signature();
+    if (signature.empty()) {
+        return 0;
+    }
+    static std::mutex keys_mutex;
+    static std::unordered_map<std::string, uint64_t> keys;
+    std::lock_guard<std::mutex> lock(keys_mutex);
+    auto it = keys.find(signature);
+    if (it != keys.end()) {
+        return it->second;
+    }
+    const auto key = static_cast<uint64_t>(keys.size() + 1);
+    keys.emplace(std::move(signature), key);
+    return key;
+}
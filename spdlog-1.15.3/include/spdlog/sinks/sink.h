@@ -6,6 +6,9 @@
 #include <spdlog/details/log_msg.h>
 #include <spdlog/formatter.h>
 
+#include <atomic>
+#include <cstdint>
+
 namespace spdlog {
 
 namespace sinks {
@@ -21,9 +24,22 @@ public:
     level::level_enum level() const;
     bool should_log(level::level_enum msg_level) const;
 
+    // Format once fan-out.
+    // Sinks returning the same non zero format_key() write the same text for a
+    // message, so the logger formats it once with log_and_format() on the first
+    // of them and hands the result to the others with log_formatted().
+    // The default key 0 opts out and the defaults below just call log().
+    uint64_t format_key() const;
+    virtual void log_and_format(const details::log_msg &msg, memory_buf_t &formatted);
+    virtual void log_formatted(const details::log_msg &msg, const memory_buf_t &formatted);
+
 protected:
     // sink log level - default is all
     level_t level_{level::trace};
+    std::atomic<uint64_t> format_key_{0};
+
+    // key shared by all formatters with the given signature, 0 for none.
+    static uint64_t format_key_of_(const spdlog::formatter *f);
 };
 
 }  // namespace sinks
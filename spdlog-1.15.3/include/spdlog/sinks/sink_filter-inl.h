@@ -0,0 +1,168 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#ifndef SPDLOG_HEADER_ONLY
+    #include <spdlog/sinks/sink_filter.h>
+#endif
+
+#include <cstring>
+
+namespace spdlog {
+namespace details {
+// part (with '?' wildcards) matches at str, which holds at least part.size() chars
+inline bool glob_part_at(const char *str, const std::string &part) {
+    for (size_t i = 0; i < part.size(); i++) {
+        if (part[i] != '?' && part[i] != str[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+}  // namespace details
+
+namespace sinks {
+
+SPDLOG_INLINE filter_rule &filter_rule::logger(const std::string &glob) {
+    logger_parts_.clear();
+    size_t start = 0;
+    for (;;) {
+        const auto star = glob.find('*', start);
+        logger_parts_.push_back(glob.substr(start, star - start));
+        if (star == std::string::npos) {
+            break;
+        }
+        start = star + 1;
+    }
+    logger_is_exact_ = logger_parts_.size() == 1 && glob.find('?') == std::string::npos;
+    has_logger_ = true;
+    return *this;
+}
+
+SPDLOG_INLINE filter_rule &filter_rule::levels(level::level_enum min_level,
+                                               level::level_enum max_level) {
+    level_mask_ = 0;
+    for (int l = min_level; l <= max_level; l++) {
+        level_mask_ |= 1u << l;
+    }
+    return *this;
+}
+
+SPDLOG_INLINE filter_rule &filter_rule::payload_prefix(std::string prefix) {
+    payload_prefix_ = std::move(prefix);
+    return *this;
+}
+
+SPDLOG_INLINE filter_rule &filter_rule::payload_contains(std::string substring) {
+    payload_contains_ = std::move(substring);
+    return *this;
+}
+
+// cheapest checks first
+SPDLOG_INLINE bool filter_rule::matches(const details::log_msg &msg) const {
+    if ((level_mask_ & (1u << msg.level)) == 0) {
+        return false;
+    }
+
+    const auto &payload = msg.payload;
+    if (!payload_prefix_.empty() &&
+        (payload.size() < payload_prefix_.size() ||
+         std::memcmp(payload.data(), payload_prefix_.data(), payload_prefix_.size()) != 0)) {
+        return false;
+    }
+
+    if (has_logger_ && !logger_matches_(msg.logger_name)) {
+        return false;
+    }
+
+    if (!payload_contains_.empty()) {
+        const char first = payload_contains_[0];
+        const size_t needle_size = payload_contains_.size();
+        const char *p = payload.data();
+        const char *last = payload.data() + payload.size();
+        for (;;) {
+            if (static_cast<size_t>(last - p) < needle_size) {
+                return false;
+            }
+            p = static_cast<const char *>(
+                std::memchr(p, first, static_cast<size_t>(last - p) - needle_size + 1));
+            if (p == nullptr) {
+                return false;
+            }
+            if (std::memcmp(p, payload_contains_.data(), needle_size) == 0) {
+                break;
+            }
+            p++;
+        }
+    }
+    return true;
+}
+
+SPDLOG_INLINE bool filter_rule::logger_matches_(string_view_t name) const {
+    if (logger_is_exact_) {
+        const auto &exact = logger_parts_[0];
+        return name.size() == exact.size() &&
+               std::memcmp(name.data(), exact.data(), exact.size()) == 0;
+    }
+
+    const auto &prefix = logger_parts_.front();
+    if (name.size() < prefix.size() || !details::glob_part_at(name.data(), prefix)) {
+        return false;
+    }
+    if (logger_parts_.size() == 1) {
+        return name.size() == prefix.size();
+    }
+
+    size_t pos = prefix.size();
+    size_t end = name.size();
+    const auto &suffix = logger_parts_.back();
+    if (end - pos < suffix.size() ||
+        !details::glob_part_at(name.data() + end - suffix.size(), suffix)) {
+        return false;
+    }
+    end -= suffix.size();
+
+    // the middle parts can match at their first occurrence
+    for (size_t i = 1; i + 1 < logger_parts_.size(); i++) {
+        const auto &part = logger_parts_[i];
+        for (;;) {
+            if (end - pos < part.size()) {
+                return false;
+            }
+            if (details::glob_part_at(name.data() + pos, part)) {
+                pos += part.size();
+                break;
+            }
+            pos++;
+        }
+    }
+    return true;
+}
+
+SPDLOG_INLINE sink_filter &sink_filter::keep(filter_rule rule) {
+    rules_.push_back(entry{std::move(rule), true});
+    return *this;
+}
+
+SPDLOG_INLINE sink_filter &sink_filter::drop(filter_rule rule) {
+    rules_.push_back(entry{std::move(rule), false});
+    return *this;
+}
+
+SPDLOG_INLINE sink_filter &sink_filter::otherwise(bool keep) {
+    keep_by_default_ = keep;
+    return *this;
+}
+
+SPDLOG_INLINE bool sink_filter::should_log(const details::log_msg &msg) const {
+    for (const auto &e : rules_) {
+        if (e.rule.matches(msg)) {
+            return e.keep;
+        }
+    }
+    return keep_by_default_;
+}
+
+}  // namespace sinks
+}  // namespace spdlog
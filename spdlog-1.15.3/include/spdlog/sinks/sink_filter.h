@@ -0,0 +1,76 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+//
+// Message filter run before formatting by base_sink (and so by dist_sink) and by the color
+// console sinks (ansicolor_sink, wincolor_sink).
+// Rules are checked in order and the first matching rule decides whether the
+// message is kept or dropped; messages matching no rule are kept unless
+// otherwise(false) was set. A rule matches if all of its conditions do.
+//
+// Example - keep the chatty "net.*" loggers out of the console below warn:
+//   console_sink->set_filter(spdlog::sinks::sink_filter().drop(
+//       spdlog::sinks::filter_rule().logger("net.*").levels(
+//           spdlog::level::trace, spdlog::level::info)));
+//
+
+#include <spdlog/common.h>
+#include <spdlog/details/log_msg.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace spdlog {
+namespace sinks {
+
+class SPDLOG_API filter_rule {
+public:
+    // logger name glob: '*' matches any run of characters, '?' any one character.
+    filter_rule &logger(const std::string &glob);
+    // inclusive level range
+    filter_rule &levels(level::level_enum min_level, level::level_enum max_level);
+    filter_rule &payload_prefix(std::string prefix);
+    filter_rule &payload_contains(std::string substring);
+
+    bool matches(const details::log_msg &msg) const;
+
+private:
+    // glob split at '*': parts_[0] must match at the start and parts_.back() at
+    // the end of the name, the others anywhere in between, in order.
+    std::vector<std::string> logger_parts_;
+    bool logger_is_exact_ = false;
+    bool has_logger_ = false;
+    uint32_t level_mask_ = ~0u;
+    std::string payload_prefix_;
+    std::string payload_contains_;
+
+    bool logger_matches_(string_view_t name) const;
+};
+
+class SPDLOG_API sink_filter {
+public:
+    sink_filter &keep(filter_rule rule);
+    sink_filter &drop(filter_rule rule);
+    // decision for messages matching no rule (default: keep)
+    sink_filter &otherwise(bool keep);
+
+    bool should_log(const details::log_msg &msg) const;
+
+private:
+    struct entry {
+        filter_rule rule;
+        bool keep;
+    };
+    std::vector<entry> rules_;
+    bool keep_by_default_ = true;
+};
+
+}  // namespace sinks
+}  // namespace spdlog
+
+#ifdef SPDLOG_HEADER_ONLY
+    #include "sink_filter-inl.h"
+#endif
@@ -32,6 +32,7 @@ SPDLOG_INLINE wincolor_sink<ConsoleMutex>::wincolor_sink(void *out_handle, color
                                FOREGROUND_BLUE |
                                FOREGROUND_INTENSITY;  // intense white on red background
     colors_[level::off] = 0;
+    format_key_.store(format_key_of_(formatter_.get()), std::memory_order_relaxed);
 }
 
 template <typename ConsoleMutex>
@@ -54,10 +55,48 @@ void SPDLOG_INLINE wincolor_sink<ConsoleMutex>::log(const details::log_msg &msg)
     }
 
     std::lock_guard<mutex_t> lock(mutex_);
+    if (filtered_out_(msg)) {
+        return;
+    }
     msg.color_range_start = 0;
     msg.color_range_end = 0;
     memory_buf_t formatted;
     formatter_->format(msg, formatted);
+    print_formatted_(msg, formatted);
+}
+
+template <typename ConsoleMutex>
+void SPDLOG_INLINE wincolor_sink<ConsoleMutex>::log_and_format(const details::log_msg &msg,
+                                                               memory_buf_t &formatted) {
+    std::lock_guard<mutex_t> lock(mutex_);
+    if (filtered_out_(msg)) {
+        return;  // leaves formatted empty, so the next sink formats for itself
+    }
+    msg.color_range_start = 0;
+    msg.color_range_end = 0;
+    formatter_->format(msg, formatted);
+    if (out_handle_ == nullptr || out_handle_ == INVALID_HANDLE_VALUE) {
+        return;
+    }
+    print_formatted_(msg, formatted);
+}
+
+template <typename ConsoleMutex>
+void SPDLOG_INLINE wincolor_sink<ConsoleMutex>::log_formatted(const details::log_msg &msg,
+                                                              const memory_buf_t &formatted) {
+    if (out_handle_ == nullptr || out_handle_ == INVALID_HANDLE_VALUE) {
+        return;
+    }
+    std::lock_guard<mutex_t> lock(mutex_);
+    if (filtered_out_(msg)) {
+        return;
+    }
+    print_formatted_(msg, formatted);
+}
+
+template <typename ConsoleMutex>
+void SPDLOG_INLINE wincolor_sink<ConsoleMutex>::print_formatted_(const details::log_msg &msg,
+                                                                 const memory_buf_t &formatted) {
     if (should_do_colors_ && msg.color_range_end > msg.color_range_start) {
         // before color range
         print_range_(formatted, 0, msg.color_range_start);
@@ -79,10 +118,23 @@ void SPDLOG_INLINE wincolor_sink<ConsoleMutex>::flush() {
     // windows console always flushed?
 }
 
+template <typename ConsoleMutex>
+void SPDLOG_INLINE wincolor_sink<ConsoleMutex>::set_filter(sink_filter filter) {
+    std::lock_guard<mutex_t> lock(mutex_);
+    filter_ = details::make_unique<sink_filter>(std::move(filter));
+}
+
+template <typename ConsoleMutex>
+void SPDLOG_INLINE wincolor_sink<ConsoleMutex>::remove_filter() {
+    std::lock_guard<mutex_t> lock(mutex_);
+    filter_.reset();
+}
+
 template <typename ConsoleMutex>
 void SPDLOG_INLINE wincolor_sink<ConsoleMutex>::set_pattern(const std::string &pattern) {
     std::lock_guard<mutex_t> lock(mutex_);
     formatter_ = std::unique_ptr<spdlog::formatter>(new pattern_formatter(pattern));
+    format_key_.store(format_key_of_(formatter_.get()), std::memory_order_relaxed);
 }
 
 template <typename ConsoleMutex>
@@ -90,6 +142,7 @@ void SPDLOG_INLINE
 wincolor_sink<ConsoleMutex>::set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) {
     std::lock_guard<mutex_t> lock(mutex_);
     formatter_ = std::move(sink_formatter);
+    format_key_.store(format_key_of_(formatter_.get()), std::memory_order_relaxed);
 }
 
 template <typename ConsoleMutex>
@@ -129,6 +182,11 @@ wincolor_sink<ConsoleMutex>::set_foreground_color_(std::uint16_t attribs) {
 }
 
 // print a range of formatted message to console
+template <typename ConsoleMutex>
+bool SPDLOG_INLINE wincolor_sink<ConsoleMutex>::filtered_out_(const details::log_msg &msg) const {
+    return filter_ != nullptr && !filter_->should_log(msg);
+}
+
 template <typename ConsoleMutex>
 void SPDLOG_INLINE wincolor_sink<ConsoleMutex>::print_range_(const memory_buf_t &formatted,
                                                              size_t start,
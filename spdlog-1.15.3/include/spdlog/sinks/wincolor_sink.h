@@ -7,6 +7,7 @@
 #include <spdlog/details/console_globals.h>
 #include <spdlog/details/null_mutex.h>
 #include <spdlog/sinks/sink.h>
+#include <spdlog/sinks/sink_filter.h>
 
 #include <array>
 #include <cstdint>
@@ -31,7 +32,14 @@ public:
 
     // change the color for the given level
     void set_color(level::level_enum level, std::uint16_t color);
+
+    // messages the filter drops are never formatted
+    void set_filter(sink_filter filter);
+    void remove_filter();
+
     void log(const details::log_msg &msg) final override;
+    void log_and_format(const details::log_msg &msg, memory_buf_t &formatted) final override;
+    void log_formatted(const details::log_msg &msg, const memory_buf_t &formatted) final override;
     void flush() final override;
     void set_pattern(const std::string &pattern) override final;
     void set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) override final;
@@ -43,8 +51,11 @@ protected:
     mutex_t &mutex_;
     bool should_do_colors_;
     std::unique_ptr<spdlog::formatter> formatter_;
+    std::unique_ptr<sink_filter> filter_;
     std::array<std::uint16_t, level::n_levels> colors_;
 
+    void print_formatted_(const details::log_msg &msg, const memory_buf_t &formatted);
+
     // set foreground color and return the orig console attributes (for resetting later)
     std::uint16_t set_foreground_color_(std::uint16_t attribs);
 
@@ -55,6 +66,8 @@ protected:
     void write_to_file_(const memory_buf_t &formatted);
 
     void set_color_mode_impl(color_mode mode);
+
+    bool filtered_out_(const details::log_msg &msg) const;
 };
 
 template <typename ConsoleMutex>
@@ -8,6 +8,7 @@
 #endif
 
 #include <spdlog/common.h>
+#include <spdlog/details/tz_cache.h>
 #include <spdlog/pattern_formatter.h>
 
 namespace spdlog {
@@ -29,6 +30,8 @@ SPDLOG_INLINE void set_pattern(std::string pattern, pattern_time_type time_type)
         std::unique_ptr<spdlog::formatter>(new pattern_formatter(std::move(pattern), time_type)));
 }
 
+SPDLOG_INLINE void refresh_timezone() { details::tz_cache::instance().refresh(); }
+
 SPDLOG_INLINE void enable_backtrace(size_t n_messages) {
     details::registry::instance().enable_backtrace(n_messages);
 }
@@ -59,6 +59,10 @@ SPDLOG_API void set_formatter(std::unique_ptr<spdlog::formatter> formatter);
 SPDLOG_API void set_pattern(std::string pattern,
                             pattern_time_type time_type = pattern_time_type::local);
 
+// Re-read the local time zone used to format log times.
+// Call it after changing the time zone of the process (e.g. the TZ env variable).
+SPDLOG_API void refresh_timezone();
+
 // enable global backtrace support
 SPDLOG_API void enable_backtrace(size_t n_messages);
 
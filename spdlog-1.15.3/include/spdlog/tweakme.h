@@ -19,6 +19,16 @@
 // #define SPDLOG_CLOCK_COARSE
 ///////////////////////////////////////////////////////////////////////////////
 
+///////////////////////////////////////////////////////////////////////////////
+// Uncomment to take log times from the CPU time stamp counter (see
+// details/tsc_clock.h) instead of the system clock. Times are then monotonic
+// and cost no system call, but don't follow wall clock adjustments (e.g. NTP)
+// made after the one-time calibration. log_msg::ticks keeps the raw counter,
+// which the %Q flag prints as nanoseconds since the calibration.
+//
+// #define SPDLOG_TSC_CLOCK
+///////////////////////////////////////////////////////////////////////////////
+
 ///////////////////////////////////////////////////////////////////////////////
 // Uncomment if source location logging is not needed.
 // This will prevent spdlog from using __FILE__, __LINE__ and SPDLOG_FUNCTION
@@ -53,6 +63,23 @@
 // #define SPDLOG_NO_ATOMIC_LEVELS
 ///////////////////////////////////////////////////////////////////////////////
 
+///////////////////////////////////////////////////////////////////////////////
+// Uncomment and set to change how many bytes of logger name + payload an async
+// message stores inline in its preallocated queue slot (default 256).
+// Larger messages borrow a block from a pool owned by the thread pool.
+//
+// #define SPDLOG_ASYNC_INLINE_MSG_SIZE 256
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// Uncomment and set to change the size of the async thread pool's priority
+// lane, which workers drain before the regular queue (default 128, 0 disables
+// it). The lane is only used once a level is set with
+// thread_pool::set_priority_level().
+//
+// #define SPDLOG_ASYNC_PRIORITY_Q_SIZE 128
+///////////////////////////////////////////////////////////////////////////////
+
 ///////////////////////////////////////////////////////////////////////////////
 // Uncomment to enable usage of wchar_t for file names on Windows.
 //
@@ -99,6 +126,29 @@
 // #define SPDLOG_PREVENT_CHILD_FD
 ///////////////////////////////////////////////////////////////////////////////
 
+///////////////////////////////////////////////////////////////////////////////
+// Uncomment (and change if desired) to make the file sinks buffer their output
+// in a user space buffer of this size, written with a single writev() to the
+// file descriptor when full or on flush, instead of going through stdio's
+// small FILE buffer. The file size is also tracked by the sink instead of
+// being queried from the OS when rotating.
+// Note that buffered messages are lost on a crash unless flushed, see
+// logger::flush_on() and spdlog::flush_every().
+//
+// #define SPDLOG_FILE_BUFFER_SIZE (1024 * 1024)
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// Uncomment (together with SPDLOG_FILE_BUFFER_SIZE) to have the file sinks
+// submit their buffers through io_uring on Linux, with a few buffers of
+// SPDLOG_FILE_BUFFER_SIZE bytes: a full buffer is written by the kernel while
+// the next one is filled, so a thread pool worker keeps formatting while the
+// disk stalls. Needs <linux/io_uring.h> at build time and a 5.6+ kernel at run
+// time; otherwise the file sinks write with writev() as without it.
+//
+// #define SPDLOG_FILE_IO_URING
+///////////////////////////////////////////////////////////////////////////////
+
 ///////////////////////////////////////////////////////////////////////////////
 // Uncomment to customize level names (e.g. "MY TRACE")
 //
@@ -7,5 +7,7 @@
 
 #include <spdlog/async.h>
 #include <spdlog/async_logger-inl.h>
+#include <spdlog/details/async_spill-inl.h>
+#include <spdlog/details/mmap_file-inl.h>
 #include <spdlog/details/periodic_worker-inl.h>
 #include <spdlog/details/thread_pool-inl.h>
@@ -30,6 +30,8 @@ template class SPDLOG_API spdlog::sinks::ansicolor_stderr_sink<spdlog::details::
 template class SPDLOG_API spdlog::sinks::ansicolor_stderr_sink<spdlog::details::console_nullmutex>;
 #endif
 
+#include <spdlog/sinks/nonblocking_console_sink-inl.h>
+
 // factory methods for color loggers
 #include "spdlog/sinks/stdout_color_sinks-inl.h"
 template SPDLOG_API std::shared_ptr<spdlog::logger>
@@ -6,6 +6,7 @@
 #endif
 
 #include <spdlog/details/file_helper-inl.h>
+#include <spdlog/details/uring_writer-inl.h>
 #include <spdlog/details/null_mutex.h>
 #include <spdlog/sinks/base_sink-inl.h>
 #include <spdlog/sinks/basic_file_sink-inl.h>
@@ -18,3 +19,15 @@ template class SPDLOG_API spdlog::sinks::basic_file_sink<spdlog::details::null_m
 #include <spdlog/sinks/rotating_file_sink-inl.h>
 template class SPDLOG_API spdlog::sinks::rotating_file_sink<std::mutex>;
 template class SPDLOG_API spdlog::sinks::rotating_file_sink<spdlog::details::null_mutex>;
+
+#include <spdlog/sinks/binary_file_sink-inl.h>
+template class SPDLOG_API spdlog::sinks::binary_file_sink<std::mutex>;
+template class SPDLOG_API spdlog::sinks::binary_file_sink<spdlog::details::null_mutex>;
+
+#include <spdlog/sinks/mmap_file_sink-inl.h>
+template class SPDLOG_API spdlog::sinks::mmap_file_sink<std::mutex>;
+template class SPDLOG_API spdlog::sinks::mmap_file_sink<spdlog::details::null_mutex>;
+
+#include <spdlog/sinks/durable_file_sink-inl.h>
+template class SPDLOG_API spdlog::sinks::durable_file_sink<std::mutex>;
+template class SPDLOG_API spdlog::sinks::durable_file_sink<spdlog::details::null_mutex>;
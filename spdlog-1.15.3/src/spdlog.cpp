@@ -12,10 +12,14 @@
 #include <spdlog/details/null_mutex.h>
 #include <spdlog/details/os-inl.h>
 #include <spdlog/details/registry-inl.h>
+#include <spdlog/details/tsc_clock-inl.h>
+#include <spdlog/details/tz_cache-inl.h>
+#include <spdlog/json_formatter-inl.h>
 #include <spdlog/logger-inl.h>
 #include <spdlog/pattern_formatter-inl.h>
 #include <spdlog/sinks/base_sink-inl.h>
 #include <spdlog/sinks/sink-inl.h>
+#include <spdlog/sinks/sink_filter-inl.h>
 #include <spdlog/spdlog-inl.h>
 
 #include <mutex>
@@ -0,0 +1,102 @@
+//
+// Copyright(c) 2015 Gabi Melman.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+// console-bench: time ansicolor_sink writing each message against batching them.
+//
+// usage: console-bench [messages] [file]
+//
+// Colored messages go to the file (/dev/null by default) through an unbuffered
+// FILE, like stderr, or to a pipe drained by another thread if the file is "pipe".
+// The runs with set_batching(0, ...) and with set_batching(64 KiB, 50 ms)
+// alternate and the fastest of each is kept, to filter out the noise of other
+// processes.
+
+#include "spdlog/logger.h"
+#include "spdlog/sinks/ansicolor_sink.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+
+#ifndef _WIN32
+    #include <unistd.h>
+#endif
+
+using std::chrono::duration;
+using std::chrono::milliseconds;
+using std::chrono::steady_clock;
+
+static double bench(FILE *target, size_t messages, size_t batch_bytes) {
+    using sink_t = spdlog::sinks::ansicolor_sink<spdlog::details::console_nullmutex>;
+    auto sink = std::make_shared<sink_t>(target, spdlog::color_mode::always);
+    sink->set_batching(batch_bytes, milliseconds(50));
+    spdlog::logger logger("console", sink);
+    const auto start = steady_clock::now();
+    for (size_t i = 0; i < messages; i++) {
+        logger.info("connection from 192.168.10.24:52814 accepted, session {} created", i);
+    }
+    logger.flush();
+    const auto elapsed = steady_clock::now() - start;
+    return duration<double, std::nano>(elapsed).count() / static_cast<double>(messages);
+}
+
+int main(int argc, char *argv[]) {
+    const size_t messages = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 500000;
+    const std::string path = argc > 2 ? argv[2] : "/dev/null";
+    const int runs = 5;
+
+    FILE *target = nullptr;
+    std::thread reader;
+#ifndef _WIN32
+    if (path == "pipe") {
+        int fds[2];
+        if (::pipe(fds) != 0) {
+            std::perror("pipe");
+            return 1;
+        }
+        const int read_fd = fds[0];
+        reader = std::thread([read_fd] {
+            char buf[64 * 1024];
+            while (::read(read_fd, buf, sizeof(buf)) > 0) {
+            }
+            ::close(read_fd);
+        });
+        target = ::fdopen(fds[1], "w");
+    }
+#endif
+    if (target == nullptr) {
+        target = std::fopen(path.c_str(), "w");
+    }
+    if (target == nullptr) {
+        std::fprintf(stderr, "can't open %s: %s\n", path.c_str(), std::strerror(errno));
+        return 1;
+    }
+    std::setvbuf(target, nullptr, _IONBF, 0);  // like stderr
+
+    // warm up
+    bench(target, messages / 10, 0);
+    double single_ns = 0, batched_ns = 0;
+    for (int run = 0; run < runs; run++) {
+        const double s_ns = bench(target, messages, 0);
+        const double b_ns = bench(target, messages, 64 * 1024);
+        single_ns = run == 0 ? s_ns : (std::min)(single_ns, s_ns);
+        batched_ns = run == 0 ? b_ns : (std::min)(batched_ns, b_ns);
+    }
+    std::fclose(target);
+    if (reader.joinable()) {
+        reader.join();
+    }
+
+    std::printf("%-28s %10s\n", path.c_str(), "ns/msg");
+    std::printf("%-28s %10.1f\n", "set_batching(0, 50ms)", single_ns);
+    std::printf("%-28s %10.1f\n", "set_batching(64 KiB, 50ms)", batched_ns);
+    std::printf("%-28s %10.2f\n", "ratio", batched_ns / single_ns);
+    return 0;
+}
@@ -0,0 +1,121 @@
+//
+// Copyright(c) 2015 Gabi Melman.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+// format-bench: time json_formatter against pattern_formatter's default pattern,
+// and, when built as C++20, compiled_formatter against pattern_formatter with the
+// same pattern.
+//
+// usage: format-bench [iterations]
+//
+// Each formatter formats the same messages into a reused buffer, with the
+// message time advancing 1us per message as in a busy logger. The runs of the
+// two formatters alternate and the fastest of each is kept, to filter out the
+// noise of other processes.
+
+#include "spdlog/compiled_formatter.h"
+#include "spdlog/json_formatter.h"
+#include "spdlog/pattern_formatter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+using std::chrono::duration;
+using std::chrono::microseconds;
+using std::chrono::steady_clock;
+
+static double bench(spdlog::formatter &formatter,
+                    const spdlog::details::log_msg &msg,
+                    size_t iterations,
+                    size_t &out_size) {
+    spdlog::memory_buf_t dest;
+    spdlog::details::log_msg m = msg;
+    size_t total = 0;
+    const auto start = steady_clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+        m.time += microseconds(1);
+        dest.clear();
+        formatter.format(m, dest);
+        total += dest.size();
+    }
+    const auto elapsed = steady_clock::now() - start;
+    out_size = total / iterations;
+    return duration<double, std::nano>(elapsed).count() / static_cast<double>(iterations);
+}
+
+struct payload {
+    const char *name;
+    std::string text;
+};
+
+using formatter_factory = std::function<std::unique_ptr<spdlog::formatter>()>;
+
+// time formatter b against formatter a on each payload
+static void compare(const std::vector<payload> &payloads,
+                    size_t iterations,
+                    const char *a_name,
+                    const formatter_factory &make_a,
+                    const char *b_name,
+                    const formatter_factory &make_b) {
+    const int runs = 5;
+    std::printf("%-18s %8s ns/msg %8s ns/msg %8s\n", "payload", a_name, b_name, "ratio");
+    for (const auto &p : payloads) {
+        spdlog::details::log_msg msg(spdlog::source_loc{}, "server", spdlog::level::info, p.text);
+        auto a = make_a();
+        auto b = make_b();
+        size_t a_size, b_size;
+        // warm up the time caches
+        bench(*a, msg, iterations / 10, a_size);
+        bench(*b, msg, iterations / 10, b_size);
+        double a_ns = 0, b_ns = 0;
+        for (int run = 0; run < runs; run++) {
+            const double run_a_ns = bench(*a, msg, iterations, a_size);
+            const double run_b_ns = bench(*b, msg, iterations, b_size);
+            a_ns = run == 0 ? run_a_ns : (std::min)(a_ns, run_a_ns);
+            b_ns = run == 0 ? run_b_ns : (std::min)(b_ns, run_b_ns);
+        }
+        std::printf("%-18s %8.1f (%3zuB) %8.1f (%3zuB) %8.2f\n", p.name, a_ns, a_size, b_ns,
+                    b_size, b_ns / a_ns);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    const size_t iterations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+
+    std::vector<payload> payloads = {
+        {"16 bytes", "request accepted"},
+        {"80 bytes",
+         "connection from 192.168.10.24:52814 accepted, session 7f3a9c created in 12 ms"},
+        {"300 bytes", std::string(300, 'x')},
+        {"80 bytes, quotes",
+         "config \"main\" loaded from \"C:\\\\app\\\\conf\\\\main.ini\" with 3 \"override\" keys"},
+    };
+
+    compare(
+        payloads, iterations, "pattern",
+        [] { return std::unique_ptr<spdlog::formatter>(new spdlog::pattern_formatter()); },
+        "json", [] { return std::unique_ptr<spdlog::formatter>(new spdlog::json_formatter()); });
+
+#if defined(__cpp_nontype_template_args) && __cpp_nontype_template_args >= 201911L
+    #define FORMAT_BENCH_PATTERN "[%Y-%m-%d %H:%M:%S.%e] [pid:%P] [thread:%t] [%n] [%^%l%$] %v"
+    std::printf("\npattern: %s\n", FORMAT_BENCH_PATTERN);
+    compare(
+        payloads, iterations, "pattern",
+        [] {
+            return std::unique_ptr<spdlog::formatter>(
+                new spdlog::pattern_formatter(FORMAT_BENCH_PATTERN));
+        },
+        "compiled",
+        [] {
+            return std::unique_ptr<spdlog::formatter>(
+                new spdlog::compiled_formatter<FORMAT_BENCH_PATTERN>());
+        });
+#endif
+    return 0;
+}
@@ -0,0 +1,98 @@
+//
+// Copyright(c) 2015 Gabi Melman.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+// spdlog-decode: print files written by binary_file_sink as text.
+//
+// usage: spdlog-decode [-p pattern] [-u] file...
+//   -p pattern   pattern_formatter pattern (default: spdlog's default pattern)
+//   -u           print times in UTC instead of local time
+
+#include "spdlog/details/binary_log.h"
+#include "spdlog/pattern_formatter.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+static void usage() {
+    std::fprintf(stderr, "usage: spdlog-decode [-p pattern] [-u] file...\n");
+}
+
+static bool read_file(const char *filename, std::vector<char> &content) {
+    std::ifstream in(filename, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+    content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return !in.bad();
+}
+
+static bool decode(const char *filename, spdlog::formatter &formatter) {
+    std::vector<char> content;
+    if (!read_file(filename, content)) {
+        std::fprintf(stderr, "spdlog-decode: cannot read %s\n", filename);
+        return false;
+    }
+
+    spdlog::details::binary_log::reader reader(content.data(), content.data() + content.size());
+    spdlog::details::log_msg msg;
+    spdlog::memory_buf_t formatted;
+    while (reader.next(msg)) {
+        formatted.clear();
+        formatter.format(msg, formatted);
+        std::fwrite(formatted.data(), 1, formatted.size(), stdout);
+    }
+
+    if (reader.bad_version()) {
+        std::fprintf(stderr, "spdlog-decode: %s: unsupported format version\n", filename);
+        return false;
+    }
+    if (reader.skipped_bytes() > 0) {
+        std::fprintf(stderr, "spdlog-decode: %s: skipped %zu damaged bytes\n", filename,
+                     reader.skipped_bytes());
+    }
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    std::string pattern;
+    auto time_type = spdlog::pattern_time_type::local;
+    std::vector<const char *> files;
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+            pattern = argv[++i];
+        } else if (std::strcmp(argv[i], "-u") == 0) {
+            time_type = spdlog::pattern_time_type::utc;
+        } else if (argv[i][0] == '-') {
+            usage();
+            return 2;
+        } else {
+            files.push_back(argv[i]);
+        }
+    }
+    if (files.empty()) {
+        usage();
+        return 2;
+    }
+
+    try {
+        std::unique_ptr<spdlog::pattern_formatter> formatter =
+            pattern.empty() ? spdlog::details::make_unique<spdlog::pattern_formatter>(time_type)
+                            : spdlog::details::make_unique<spdlog::pattern_formatter>(
+                                  pattern, time_type);
+        bool ok = true;
+        for (auto file : files) {
+            ok = decode(file, *formatter) && ok;
+        }
+        return ok ? 0 : 1;
+    } catch (const spdlog::spdlog_ex &ex) {
+        std::fprintf(stderr, "spdlog-decode: %s\n", ex.what());
+        return 1;
+    }
+}